@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# A/B comparison of two builds (make bench); the results are saved to abCompare.json
+#   ab.sh save «dir»                     copies the present binaries to «dir» (e.g. before a change)
+#   ab.sh «dirA» «dirB» [«pairs»] [«config»]   runs both builds interleaved over the same seeds
+
+BINS="probSemSharedMemRestaurant chef waiter group receptionist"
+
+if [ "$1" = "save" ] && [ $# -eq 2 ]; then
+    mkdir -p "$2" && cp $BINS "$2"/
+    exit $?
+fi
+
+if [ $# -lt 2 ]; then
+    echo "USAGE: $0 save «dir» | $0 «dirA» «dirB» [«pairs»] [«config»]"
+    exit 1
+fi
+
+n=${3:-20}
+config=${4:-config.txt}
+
+if ! [ $n -gt 1 ] 2>/dev/null; then
+    echo "Wrong argument value (\"$n\"). Aborting."
+    exit 1
+fi
+
+if ! [ -x ./abCompare ]; then
+    echo "abCompare not found; build it with \"make bench\" in ../src. Aborting."
+    exit 1
+fi
+
+./abCompare -n $n -o abCompare.json "$1" "$2" $config
@@ -1,18 +1,22 @@
 #!/bin/bash
 
+# runs every config the given number of times through the benchmark driver (make bench);
+# the measurements are saved to runBench.json
+
 case $# in
-    0) n=1000;;
-    1) n=$1;;
-    *) echo "USAGE: $0 «number-of-runs»"; exit;;
+    0) n=1000; configs=config.txt;;
+    *) n=$1; shift; configs=${@:-config.txt};;
 esac
 
 if ! [ $n -gt 0 ] 2>/dev/null; then
     echo "Wrong argument value (\"$n\"). Aborting."
+    echo "USAGE: $0 «number-of-runs» [«config» ...]"
+    exit 1
+fi
+
+if ! [ -x ./runBench ]; then
+    echo "runBench not found; build it with \"make bench\" in ../src. Aborting."
     exit 1
 fi
 
-for i in $(seq 1 $n)
-do
-     echo -e "\n\e[34;1mRun n.º $i\e[0m"
-     ./probSemSharedMemRestaurant
-done
+./runBench -n $n -o runBench.json $configs
@@ -0,0 +1,36 @@
+#!/bin/bash
+
+# checks that logCheck (make bench) counts the visits of a continuous mode run as the launcher does
+#   soakcheck.sh «config»          runs the launcher on «config» (with #continuous), saving soakcheck.log and
+#                                  soakcheck.txt (the report), and compares them
+#   soakcheck.sh «log» «report»    compares an existing log with the report the launcher printed for it
+
+case $# in
+    1) log=soakcheck.log; report=soakcheck.txt
+       if ! grep -q "^#continuous" "$1"; then
+           echo "\"$1\" has no #continuous setting. Aborting."
+           exit 1
+       fi
+       ./probSemSharedMemRestaurant -c "$1" $log > $report 2> /dev/null || exit 1;;
+    2) log=$1; report=$2;;
+    *) echo "USAGE: $0 «config» | $0 «log» «report»"
+       exit 1;;
+esac
+
+if ! [ -x ./logCheck ]; then
+    echo "logCheck not found; build it with \"make bench\" in ../src. Aborting."
+    exit 1
+fi
+
+launcher=$( awk '/visits served/ { print $4 }' $report )
+checked=$( ./logCheck $log | awk '/^visits/ { print $3 }' )
+
+if [ -z "$launcher" ] || [ -z "$checked" ]; then
+    echo "visits served not found in the report or in the output of logCheck. Aborting."
+    exit 1
+fi
+if [ "$launcher" != "$checked" ]; then
+    echo "visits served: $launcher in the report, $checked counted by logCheck"
+    exit 1
+fi
+echo "visits served: $launcher (report and logCheck agree)"
@@ -0,0 +1,261 @@
+/**
+ *  \file abCompare.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  A/B comparison of two builds.
+ *
+ *  Runs the simulation alternately with the binaries of two directories (A and B), over the same config file
+ *  and the same sequence of seeds, so that both builds face identical workloads and any drift of the machine
+ *  affects both alike (the order of A and B is swapped on every pair). For every run the wall time, the CPU time,
+ *  the context switches and the mean latency of each phase of the lifecycle of the groups (see lifecycle.h) are
+ *  measured. The two runs of a pair share the seed, so the runs are compared pair by pair: for each measurement
+ *  the mean of the differences (B - A), its confidence interval and the p-value of the paired t-test are printed
+ *  and saved as JSON. A pair where either run failed is left out.
+ *
+ *  Usage: abCompare [-n pairs] [-s seed] [-o report] [-l logfile] dirA dirB config
+ *
+ *  Each directory must hold a complete set of binaries (launcher and entities), e.g. a copy of the run directory
+ *  made before a change. The exit status is EXIT_FAILURE if any run failed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <math.h>
+#include <unistd.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "runner.h"
+#include "stats.h"
+
+/** \brief default number of pairs of runs */
+#define  DEFPAIRS           20
+
+/** \brief default seed of the first pair */
+#define  DEFSEED            1
+
+/** \brief confidence level of the intervals */
+#define  CONFLEVEL          0.95
+
+/** \brief number of run measurements (wall, cpu, voluntary and involuntary context switches) */
+#define  NRUNMEAS           4
+
+/** \brief number of measurements (run measurements followed by the mean latency of each phase) */
+#define  NMEAS              (NRUNMEAS+NPHASES)
+
+/** \brief name of the launcher */
+#define  LAUNCHER           "probSemSharedMemRestaurant"
+
+/** \brief names of the run measurements */
+static const char *runMeasName[NRUNMEAS] = { "wall_us", "cpu_us", "voluntary_csw", "involuntary_csw" };
+
+/** \brief measurements of every run of a build */
+typedef struct {
+    const char *dir;                                                                    /* directory of the binaries */
+    int nRuns,                                           /* number of runs kept (pairs where both runs succeeded) */
+        nFailed;                                                                           /* number of failed runs */
+    double *meas[NMEAS];                                                               /* measurements, per run */
+} SERIES;
+
+/** \brief comparison of a measurement between the two builds */
+typedef struct {
+    double meanA, meanB,                                                                    /* means of each build */
+           diff,                                                          /* mean of the differences of the pairs */
+           low, high,                                                      /* confidence interval of the difference */
+           t, df,                                                  /* statistic and degrees of freedom of the test */
+           p;                                                                                          /* p-value */
+} COMPARISON;
+
+/** \brief name of a measurement */
+static const char *measName (int m)
+{
+    static char name[NPHASES][32];
+
+    if (m < NRUNMEAS) {
+        return runMeasName[m];
+    }
+    snprintf (name[m-NRUNMEAS], sizeof (name[0]), "%s_us", phaseName (m - NRUNMEAS));
+    return name[m-NRUNMEAS];
+}
+
+/** \brief allocating the measurements of a build */
+static void initSeries (SERIES *s, const char *dir, int nPairs)
+{
+    char launcher[PATH_MAX];
+    int m;
+
+    snprintf (launcher, sizeof (launcher), "%s/%s", dir, LAUNCHER);
+    if (access (launcher, X_OK) == -1) {
+        perror (launcher);
+        exit (EXIT_FAILURE);
+    }
+    s->dir = dir;
+    s->nRuns = s->nFailed = 0;
+    for (m = 0; m < NMEAS; m++) {
+        if ((s->meas[m] = malloc (nPairs * sizeof (double))) == NULL) {
+            perror ("error on allocating the measurements");
+            exit (EXIT_FAILURE);
+        }
+    }
+}
+
+/** \brief running a build once and storing its measurements in the next free position (kept by keepRun) */
+static bool runBuild (SERIES *s, const char *config, const char *log, unsigned int seed)
+{
+    RUNRESULT r;
+    double sum;
+    int p, k;
+
+    if (runOnce (s->dir, config, log, seed, &r) == -1) {
+        s->nFailed += 1;
+        return false;
+    }
+    s->meas[0][s->nRuns] = (double) r.wall;
+    s->meas[1][s->nRuns] = (double) r.cpu;
+    s->meas[2][s->nRuns] = (double) r.nvcsw;
+    s->meas[3][s->nRuns] = (double) r.nivcsw;
+    for (p = 0; p < NPHASES; p++) {
+        for (sum = 0.0, k = 0; k < r.nSamples; k++) {
+            sum += r.phase[p][k];
+        }
+        s->meas[NRUNMEAS+p][s->nRuns] = (r.nSamples > 0) ? sum / r.nSamples : 0.0;
+    }
+    return true;
+}
+
+/** \brief mean of the differences of a measurement over the pairs, with the paired t-test */
+static void compare (double a[], double b[], double d[], int n, COMPARISON *c)
+{
+    double se, q;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        d[i] = b[i] - a[i];
+    }
+    c->meanA = statMean (a, n);
+    c->meanB = statMean (b, n);
+    c->diff = statMean (d, n);
+    c->df = (n > 1) ? n - 1 : 1;
+    se = (n > 1) ? sqrt (statVariance (d, n) / n) : 0.0;                 /* standard error of the mean difference */
+    if (se == 0.0) {                                                       /* no spread: nothing can be concluded */
+        c->t = 0.0;
+        c->p = 1.0;
+        c->low = c->high = c->diff;
+        return;
+    }
+    c->t = c->diff / se;
+    c->p = 2.0 * (1.0 - statStudentCdf (fabs (c->t), c->df));
+    q = statStudentQuantile (1.0 - (1.0 - CONFLEVEL) / 2.0, c->df);
+    c->low = c->diff - q * se;
+    c->high = c->diff + q * se;
+}
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to run both builds the requested number of times, interleaved, and report their differences.
+ */
+int main (int argc, char *argv[])
+{
+    char *nRep = "abCompare.json",                                                      /* name of the report file */
+         *nLog = "abCompare.log",                              /* name of the logging file of the runs (in each dir) */
+         *config;
+    unsigned int seed = DEFSEED;
+    int nPairs = DEFPAIRS, i, m, opt;
+    SERIES s[2];
+    COMPARISON c[NMEAS];
+    double *d;                                                              /* differences of the pairs (B - A) */
+    bool okA, okB;
+    FILE *fp;
+
+    while ((opt = getopt (argc, argv, "n:s:o:l:")) != -1) {
+        switch (opt) {
+            case 'n': nPairs = atoi (optarg);
+                      break;
+            case 's': seed = (unsigned int) strtoul (optarg, NULL, 10);
+                      break;
+            case 'o': nRep = optarg;
+                      break;
+            case 'l': nLog = optarg;
+                      break;
+            default:  fprintf (stderr, "Usage: %s [-n pairs] [-s seed] [-o report] [-l logfile] dirA dirB config\n", argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if ((nPairs < 2) || (seed == 0) || (argc - optind != 3)) {
+        fprintf (stderr, "Usage: %s [-n pairs (>= 2)] [-s seed (> 0)] [-o report] [-l logfile] dirA dirB config\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+    initSeries (&s[0], argv[optind], nPairs);
+    initSeries (&s[1], argv[optind+1], nPairs);
+    config = argv[optind+2];
+
+    /* pair i runs both builds with the same seed; the streams of the entities of consecutive seeds do not overlap */
+    for (i = 0; i < nPairs; i++) {
+        fprintf (stderr, "\rpair %d/%d", i + 1, nPairs);
+        if (i % 2 == 0) {
+            okA = runBuild (&s[0], config, nLog, seed + i * NUSAGE);
+            okB = runBuild (&s[1], config, nLog, seed + i * NUSAGE);
+        }
+        else {
+            okB = runBuild (&s[1], config, nLog, seed + i * NUSAGE);
+            okA = runBuild (&s[0], config, nLog, seed + i * NUSAGE);
+        }
+        if (okA && okB) {                                               /* both runs of the pair are kept, or none */
+            s[0].nRuns += 1;
+            s[1].nRuns += 1;
+        }
+    }
+    fprintf (stderr, "\n");
+    if ((d = malloc (nPairs * sizeof (double))) == NULL) {
+        perror ("error on allocating the differences");
+        exit (EXIT_FAILURE);
+    }
+    for (m = 0; m < NMEAS; m++) {
+        compare (s[0].meas[m], s[1].meas[m], d, s[0].nRuns, &c[m]);
+    }
+    free (d);
+
+    /* human readable summary */
+    printf ("A: %s (%d failed)\nB: %s (%d failed)\n%d pairs compared\n", s[0].dir, s[0].nFailed,
+            s[1].dir, s[1].nFailed, s[0].nRuns);
+    printf ("%-18s %12s %12s %12s %8s %25s %8s\n", "measurement", "mean A", "mean B", "B - A", "%", "confidence interval", "p");
+    for (m = 0; m < NMEAS; m++) {
+        printf ("%-18s %12.1f %12.1f %12.1f %+7.2f%% [%11.1f, %11.1f] %8.4f%s\n", measName (m), c[m].meanA, c[m].meanB,
+                c[m].diff, (c[m].meanA != 0.0) ? 100.0 * c[m].diff / c[m].meanA : 0.0, c[m].low, c[m].high, c[m].p,
+                (c[m].p < 1.0 - CONFLEVEL) ? " *" : "");
+    }
+    printf ("(%.0f%% confidence intervals of the mean of B - A over the pairs; * significant at the %.2f level, "
+            "paired t-test, %d degrees of freedom)\n", 100.0 * CONFLEVEL, 1.0 - CONFLEVEL, (int) c[0].df);
+
+    /* machine-readable report */
+    if ((fp = fopen (nRep, "w")) == NULL) {
+        perror ("error on creating the report file");
+        exit (EXIT_FAILURE);
+    }
+    fprintf (fp, "{\n  \"config\": \"%s\",\n  \"pairs\": %d,\n  \"pairs_compared\": %d,\n  \"seed\": %u,\n"
+             "  \"confidence\": %.2f,\n  \"test\": \"paired t\",\n", config, nPairs, s[0].nRuns, seed, CONFLEVEL);
+    for (i = 0; i < 2; i++) {
+        fprintf (fp, "  \"%c\": {\"dir\": \"%s\", \"runs\": %d, \"failed\": %d},\n", 'a' + i, s[i].dir, s[i].nRuns,
+                 s[i].nFailed);
+    }
+    fprintf (fp, "  \"measurements\": {\n");
+    for (m = 0; m < NMEAS; m++) {
+        fprintf (fp, "    \"%s\": {\"mean_a\": %.1f, \"mean_b\": %.1f, \"mean_diff\": %.1f, \"ci_low\": %.1f, \"ci_high\": %.1f, "
+                 "\"t\": %.4f, \"df\": %.0f, \"p\": %.6f}%s\n", measName (m), c[m].meanA, c[m].meanB, c[m].diff,
+                 c[m].low, c[m].high, c[m].t, c[m].df, c[m].p, (m < NMEAS - 1) ? "," : "");
+    }
+    fprintf (fp, "  }\n}\n");
+    fclose (fp);
+
+    for (i = 0; i < 2; i++) {
+        for (m = 0; m < NMEAS; m++) {
+            free (s[i].meas[m]);
+        }
+    }
+
+    return (s[0].nFailed + s[1].nFailed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
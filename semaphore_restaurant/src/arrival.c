@@ -0,0 +1,84 @@
+/**
+ *  \file arrival.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Arrival queue of the groups, served by the pool of group agents.
+ *
+ *  Defined operations:
+ *     \li initialization of the arrival queue
+ *     \li insertion of a group that starts a new visit
+ *     \li removal of the next group by an agent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "arrival.h"
+
+/* external functions */
+
+/**
+ *  \brief Initialization of the arrival queue.
+ *
+ *  All groups are queued, in the order of their start times, with their trips counted from the start of operations.
+ *  The start times and the time stamp of the start of operations must have been set.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+void arrivalInit (FULL_STAT *p_fSt)
+{
+    int g, i;
+
+    for (g = 0; g < p_fSt->nGroups; g++) {                      /* insertion sort, stable on equal start times */
+        for (i = g; (i > 0) && (p_fSt->startTime[p_fSt->arrival[i-1]] > p_fSt->startTime[g]); i--) {
+            p_fSt->arrival[i] = p_fSt->arrival[i-1];
+        }
+        p_fSt->arrival[i] = g;
+        p_fSt->arrivalSince[g] = p_fSt->runStart;
+        p_fSt->visitAgent[g] = -1;
+    }
+    p_fSt->arrivalHead = 0;
+    p_fSt->arrivalCount = p_fSt->nGroups;
+}
+
+/**
+ *  \brief Insertion of a group that starts a new visit.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param since time stamp (us) from which the trip of the group to the restaurant is counted
+ */
+void arrivalPush (FULL_STAT *p_fSt, int g, long long since)
+{
+    p_fSt->arrival[(p_fSt->arrivalHead + p_fSt->arrivalCount++) % p_fSt->nGroups] = g;
+    p_fSt->arrivalSince[g] = since;
+}
+
+/**
+ *  \brief Removal of the next group by an agent.
+ *
+ *  The agent becomes the one living the visit of the group (see groupAgent).
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param agent agent id
+ *  \param since time stamp (us) from which the trip of the group to the restaurant is counted (filled in)
+ *
+ *  \return group id, or -\c 1 if the queue is empty
+ */
+int arrivalPop (FULL_STAT *p_fSt, int agent, long long *since)
+{
+    int g;
+
+    if (p_fSt->arrivalCount == 0) {
+        return -1;
+    }
+    g = p_fSt->arrival[p_fSt->arrivalHead];
+    p_fSt->arrivalHead = (p_fSt->arrivalHead + 1) % p_fSt->nGroups;
+    p_fSt->arrivalCount--;
+    p_fSt->visitAgent[g] = agent;
+    *since = p_fSt->arrivalSince[g];
+    return g;
+}
@@ -0,0 +1,61 @@
+/**
+ *  \file arrival.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Arrival queue of the groups, served by the pool of group agents.
+ *
+ *  Defined operations:
+ *     \li initialization of the arrival queue
+ *     \li insertion of a group that starts a new visit
+ *     \li removal of the next group by an agent.
+ *
+ *  A group agent is a process that lives the visits of the groups, one visit at a time: it takes the next group
+ *  from the arrival queue, goes through the whole life cycle of the group and takes the next one. The number of
+ *  agents bounds the groups that are in the restaurant (or on their way to it) at the same time, independently of
+ *  the number of groups, and the agent of a visit is the one that waits for its table. The queue starts with all
+ *  groups, in the order of their start times; in the continuous mode a group that comes back is put at its end.
+ *  The agents bound the processes and the semaphores, not the groups: the per-group state in the shared region
+ *  (this queue included) is still sized by MAXGROUPS at compile time (make CFLAGS="-Wall -DMAXGROUPS=n" raises
+ *  it), and many visits come from the continuous mode, where a fixed set of groups keeps coming back.
+ *  The operations must be called within the critical region.
+ */
+
+#ifndef ARRIVAL_H_
+#define ARRIVAL_H_
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Initialization of the arrival queue.
+ *
+ *  All groups are queued, in the order of their start times, with their trips counted from the start of operations.
+ *  The start times and the time stamp of the start of operations must have been set.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+extern void arrivalInit (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Insertion of a group that starts a new visit.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param since time stamp (us) from which the trip of the group to the restaurant is counted
+ */
+extern void arrivalPush (FULL_STAT *p_fSt, int g, long long since);
+
+/**
+ *  \brief Removal of the next group by an agent.
+ *
+ *  The agent becomes the one living the visit of the group (see groupAgent).
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param agent agent id
+ *  \param since time stamp (us) from which the trip of the group to the restaurant is counted (filled in)
+ *
+ *  \return group id, or -\c 1 if the queue is empty
+ */
+extern int arrivalPop (FULL_STAT *p_fSt, int agent, long long *since);
+
+#endif /* ARRIVAL_H_ */
@@ -0,0 +1,246 @@
+/**
+ *  \file csprof.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Profiling of semaphore operations per call site.
+ *
+ *  Defined operations:
+ *     \li creation of the profiling region
+ *     \li destruction of the profiling region
+ *     \li profiled <em>down</em> of a semaphore
+ *     \li profiled <em>up</em> of a semaphore
+ *     \li printing the ranked report of the call sites.
+ */
+
+/* the profiled operations call the real ones */
+#define CSPROF_IMPL
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "timing.h"
+#include "csprof.h"
+
+/** \brief largest semaphore location tracked for hold times */
+#define  MAXSEMS            256
+
+/** \brief shared memory block access identifier */
+static int shmid = -1;
+
+/** \brief call site table (shared memory region) */
+static CSSITE *sites = NULL;
+
+/** \brief the profiling region could not be found, so this process is not profiled */
+static bool disabled = false;
+
+/** \brief time stamp (ns) of the last <em>down</em> of each semaphore by this process */
+static long long acqTime[MAXSEMS];
+
+/** \brief call site of the last <em>down</em> of each semaphore by this process (NULL if released) */
+static CSSITE *acqSite[MAXSEMS];
+
+/* internal functions */
+
+/** \brief access key to the profiling region */
+static int regionKey (void)
+{
+    return ftok (".", 'p');
+}
+
+/** \brief attaching the profiling region, on first use */
+static bool attach (void)
+{
+    if ((sites == NULL) && !disabled) {
+        if (((shmid = shmemConnect (regionKey ())) == -1) || (shmemAttach (shmid, (void **) &sites) == -1)) {
+            sites = NULL;
+            disabled = true;
+        }
+    }
+    return sites != NULL;
+}
+
+/** \brief hash of a call site (never 0) */
+static unsigned long long siteKey (const char *file, int line)
+{
+    unsigned long long h = 1469598103934665603ULL;                                                  /* FNV-1a */
+
+    while (*file != '\0') {
+        h = (h ^ (unsigned char) *file++) * 1099511628211ULL;
+    }
+    h = (h ^ (unsigned long long) line) * 1099511628211ULL;
+    return (h == 0) ? 1 : h;
+}
+
+/** \brief slot of a call site, claimed on first use (NULL if the table is full) */
+static CSSITE *siteOf (unsigned int sindex, const char *file, const char *func, int line)
+{
+    unsigned long long key = siteKey (file, line), cur;
+    int i, s;
+
+    for (i = 0; i < MAXSITES; i++) {
+        s = (int) ((key + i) % MAXSITES);
+        cur = __atomic_load_n (&sites[s].key, __ATOMIC_ACQUIRE);
+        if (cur == 0) {
+            if (__atomic_compare_exchange_n (&sites[s].key, &cur, key, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                snprintf (sites[s].tag, SITELEN, "%s:%d %s", file, line, func);
+                sites[s].sindex = sindex;
+                return &sites[s];
+            }
+        }
+        if (cur == key) {
+            return &sites[s];
+        }
+    }
+    return NULL;
+}
+
+/** \brief atomic update of a maximum */
+static void atomicMax (long long *max, long long v)
+{
+    long long cur = __atomic_load_n (max, __ATOMIC_RELAXED);
+
+    while ((v > cur) && !__atomic_compare_exchange_n (max, &cur, v, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+}
+
+/** \brief ranking of the call sites, by decreasing wait plus hold time */
+static int cmpSite (const void *a, const void *b)
+{
+    const CSSITE *x = *(CSSITE * const *) a, *y = *(CSSITE * const *) b;
+    long long tx = x->waitSum + x->holdSum, ty = y->waitSum + y->holdSum;
+
+    return (ty > tx) - (ty < tx);
+}
+
+/* external functions */
+
+/**
+ *  \brief Creation of the profiling region.
+ *
+ *  Must be called by the launcher before the intervening entities are generated.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+int csprofCreate (void)
+{
+    if (((shmid = shmemCreate (regionKey (), MAXSITES * sizeof (CSSITE))) == -1) ||
+        (shmemAttach (shmid, (void **) &sites) == -1)) {
+        return -1;
+    }
+    memset (sites, 0, MAXSITES * sizeof (CSSITE));
+    return 0;
+}
+
+/**
+ *  \brief Destruction of the profiling region.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+int csprofDestroy (void)
+{
+    if ((shmemDettach (sites) == -1) || (shmemDestroy (shmid) == -1)) {
+        return -1;
+    }
+    sites = NULL;
+    return 0;
+}
+
+/**
+ *  \brief Profiled <em>down</em> of a semaphore within the set.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param file file of the call site
+ *  \param func function of the call site
+ *  \param line line of the call site
+ *
+ *  \return result of semDown
+ */
+int csprofDown (int semgid, unsigned int sindex, const char *file, const char *func, int line)
+{
+    CSSITE *site;
+    long long t0, t1;
+    int ret;
+
+    if (!attach () || ((site = siteOf (sindex, file, func, line)) == NULL)) {
+        return semDown (semgid, sindex);
+    }
+    t0 = timeNowNs ();
+    ret = semDown (semgid, sindex);
+    t1 = timeNowNs ();
+    if (ret == 0) {
+        __atomic_fetch_add (&site->nDown, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add (&site->waitSum, t1 - t0, __ATOMIC_RELAXED);
+        atomicMax (&site->waitMax, t1 - t0);
+        if (sindex < MAXSEMS) {
+            acqTime[sindex] = t1;
+            acqSite[sindex] = site;
+        }
+    }
+    return ret;
+}
+
+/**
+ *  \brief Profiled <em>up</em> of a semaphore within the set.
+ *
+ *  If the same process did the last <em>down</em> of the semaphore, the hold time is charged to the
+ *  call site of that <em>down</em>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return result of semUp
+ */
+int csprofUp (int semgid, unsigned int sindex)
+{
+    CSSITE *site;
+    long long hold;
+
+    if ((sindex < MAXSEMS) && ((site = acqSite[sindex]) != NULL)) {
+        hold = timeNowNs () - acqTime[sindex];
+        __atomic_fetch_add (&site->nHold, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add (&site->holdSum, hold, __ATOMIC_RELAXED);
+        atomicMax (&site->holdMax, hold);
+        acqSite[sindex] = NULL;
+    }
+    return semUp (semgid, sindex);
+}
+
+/**
+ *  \brief Printing the report of the call sites, ranked by total wait plus hold time.
+ *
+ *  Must be called after all intervening entities have terminated.
+ *
+ *  \param fic stream where the report is printed
+ */
+void csprofReport (FILE *fic)
+{
+    CSSITE *rank[MAXSITES];
+    int s, n = 0;
+
+    for (s = 0; s < MAXSITES; s++) {
+        if (sites[s].key != 0) {
+            rank[n++] = &sites[s];
+        }
+    }
+    qsort (rank, n, sizeof (CSSITE *), cmpSite);
+
+    fprintf (fic, "\nSemaphore call sites (ranked by wait + hold time)\n");
+    fprintf (fic, "%-56s %4s %7s %10s %9s %9s %7s %10s %9s %9s\n", "site", "sem", "downs",
+             "wait ms", "mean us", "max us", "holds", "hold ms", "mean us", "max us");
+    for (s = 0; s < n; s++) {
+        fprintf (fic, "%-56s %4u %7lld %10.3f %9.2f %9.1f %7lld %10.3f %9.2f %9.1f\n", rank[s]->tag, rank[s]->sindex,
+                 rank[s]->nDown, rank[s]->waitSum / 1e6, (rank[s]->nDown > 0) ? rank[s]->waitSum / 1e3 / rank[s]->nDown : 0.0,
+                 rank[s]->waitMax / 1e3, rank[s]->nHold, rank[s]->holdSum / 1e6,
+                 (rank[s]->nHold > 0) ? rank[s]->holdSum / 1e3 / rank[s]->nHold : 0.0, rank[s]->holdMax / 1e3);
+    }
+}
@@ -0,0 +1,111 @@
+/**
+ *  \file csprof.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Profiling of semaphore operations per call site.
+ *
+ *  Defined operations:
+ *     \li creation of the profiling region
+ *     \li destruction of the profiling region
+ *     \li profiled <em>down</em> of a semaphore
+ *     \li profiled <em>up</em> of a semaphore
+ *     \li printing the ranked report of the call sites.
+ *
+ *  In the instrumentation build (<tt>make prof</tt>, which defines CSPROF) semaphore.h maps every
+ *  <em>down</em> and <em>up</em> onto the profiled versions, tagged with the file, function and line
+ *  of the call. For each call site the time spent blocked in <em>down</em> (wait time) and the time
+ *  until the same process does the matching <em>up</em> (hold time, meaningful for the mutex) are
+ *  accumulated in a shared memory region, with atomic operations, so that the figures of all the
+ *  processes add up. The launcher creates the region and prints the report at shutdown.
+ */
+
+#ifndef CSPROF_H_
+#define CSPROF_H_
+
+#include <stdio.h>
+
+/** \brief maximum number of call sites profiled */
+#define  MAXSITES           128
+
+/** \brief maximum length of the tag of a call site */
+#define  SITELEN            64
+
+/**
+ *  \brief Definition of the counters of a call site.
+ */
+typedef struct {
+    /** \brief hash of file and line of the call site (0 if the slot is free) */
+    unsigned long long key;
+    /** \brief tag of the call site (file:line function) */
+    char tag[SITELEN];
+    /** \brief semaphore location in the set */
+    unsigned int sindex;
+    /** \brief number of <em>down</em> operations */
+    long long nDown;
+    /** \brief total time (ns) blocked in <em>down</em> */
+    long long waitSum;
+    /** \brief largest time (ns) blocked in <em>down</em> */
+    long long waitMax;
+    /** \brief number of matching <em>up</em> operations by the same process */
+    long long nHold;
+    /** \brief total time (ns) between <em>down</em> and matching <em>up</em> */
+    long long holdSum;
+    /** \brief largest time (ns) between <em>down</em> and matching <em>up</em> */
+    long long holdMax;
+} CSSITE;
+
+/**
+ *  \brief Creation of the profiling region.
+ *
+ *  Must be called by the launcher before the intervening entities are generated.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+extern int csprofCreate (void);
+
+/**
+ *  \brief Destruction of the profiling region.
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+extern int csprofDestroy (void);
+
+/**
+ *  \brief Profiled <em>down</em> of a semaphore within the set.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param file file of the call site
+ *  \param func function of the call site
+ *  \param line line of the call site
+ *
+ *  \return result of semDown
+ */
+extern int csprofDown (int semgid, unsigned int sindex, const char *file, const char *func, int line);
+
+/**
+ *  \brief Profiled <em>up</em> of a semaphore within the set.
+ *
+ *  If the same process did the last <em>down</em> of the semaphore, the hold time is charged to the
+ *  call site of that <em>down</em>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return result of semUp
+ */
+extern int csprofUp (int semgid, unsigned int sindex);
+
+/**
+ *  \brief Printing the report of the call sites, ranked by total wait plus hold time.
+ *
+ *  Must be called after all intervening entities have terminated.
+ *
+ *  \param fic stream where the report is printed
+ */
+extern void csprofReport (FILE *fic);
+
+#endif /* CSPROF_H_ */
@@ -0,0 +1,142 @@
+/**
+ *  \file histogram.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Latency histograms with bounded relative error.
+ *
+ *  Defined operations:
+ *     \li initialization of a histogram
+ *     \li recording a value
+ *     \li merging a histogram into another
+ *     \li percentile of the recorded values.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "histogram.h"
+
+/* internal functions */
+
+/** \brief bucket of a non negative value */
+static int bucketOf (long long v)
+{
+    int e = (63 - __builtin_clzll ((unsigned long long) v | 1)) - HISTSUBBITS;      /* magnitude above the exact range */
+
+    return (e <= 0) ? (int) v : HISTSUB * e + (int) (v >> e);
+}
+
+/** \brief smallest value of a bucket */
+static long long bucketLow (int b)
+{
+    int e = b / HISTSUB - 1;
+
+    return (e <= 0) ? b : (long long) (b - HISTSUB * e) << e;
+}
+
+/** \brief width of a bucket */
+static long long bucketWidth (int b)
+{
+    int e = b / HISTSUB - 1;
+
+    return (e <= 0) ? 1 : 1LL << e;
+}
+
+/* external functions */
+
+/**
+ *  \brief Initialization of a histogram.
+ *
+ *  \param h pointer to the histogram
+ */
+void histInit (HISTOGRAM *h)
+{
+    memset (h->count, 0, sizeof (h->count));
+    h->n = h->min = h->max = 0;
+    h->sum = 0.0;
+}
+
+/**
+ *  \brief Recording a value.
+ *
+ *  Negative values are recorded as 0.
+ *
+ *  \param h pointer to the histogram
+ *  \param v value
+ */
+void histRecord (HISTOGRAM *h, long long v)
+{
+    if (v < 0) {
+        v = 0;
+    }
+    h->count[bucketOf (v)] += 1;
+    if ((h->n == 0) || (v < h->min)) {
+        h->min = v;
+    }
+    if ((h->n == 0) || (v > h->max)) {
+        h->max = v;
+    }
+    h->n += 1;
+    h->sum += v;
+}
+
+/**
+ *  \brief Merging a histogram into another.
+ *
+ *  \param h pointer to the histogram that receives the values
+ *  \param o pointer to the histogram whose values are added
+ */
+void histMerge (HISTOGRAM *h, const HISTOGRAM *o)
+{
+    int b;
+
+    if (o->n == 0) {
+        return;
+    }
+    for (b = 0; b < HISTBUCKETS; b++) {
+        h->count[b] += o->count[b];
+    }
+    if ((h->n == 0) || (o->min < h->min)) {
+        h->min = o->min;
+    }
+    if ((h->n == 0) || (o->max > h->max)) {
+        h->max = o->max;
+    }
+    h->n += o->n;
+    h->sum += o->sum;
+}
+
+/**
+ *  \brief Percentile of the recorded values.
+ *
+ *  The value returned is the middle of the bucket where the percentile falls, clamped to the
+ *  smallest and largest values recorded.
+ *
+ *  \param h pointer to the histogram
+ *  \param p percentile (0 .. 100)
+ *
+ *  \return value of the percentile (0 for an empty histogram)
+ */
+long long histPercentile (HISTOGRAM *h, double p)
+{
+    long long rank, seen = 0, v;
+    int b;
+
+    if (h->n == 0) {
+        return 0;
+    }
+    rank = (long long) (p / 100.0 * h->n + 0.5);                              /* number of values at or below */
+    if (rank < 1) {
+        rank = 1;
+    }
+    for (b = 0; b < HISTBUCKETS; b++) {
+        seen += h->count[b];
+        if (seen >= rank) {
+            break;
+        }
+    }
+    v = bucketLow (b) + (bucketWidth (b) - 1) / 2;
+    return (v < h->min) ? h->min : (v > h->max) ? h->max : v;
+}
@@ -0,0 +1,86 @@
+/**
+ *  \file histogram.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Latency histograms with bounded relative error.
+ *
+ *  Defined operations:
+ *     \li initialization of a histogram
+ *     \li recording a value
+ *     \li merging a histogram into another
+ *     \li percentile of the recorded values.
+ *
+ *  Buckets are log-linear, as in HDR histograms: values below 2*HISTSUB are counted exactly and every
+ *  power of two above is split into HISTSUB linear sub-buckets, so the relative error is below 1/HISTSUB
+ *  whatever the magnitude. Recording is constant time and the memory used does not depend on the
+ *  number of values.
+ */
+
+#ifndef HISTOGRAM_H_
+#define HISTOGRAM_H_
+
+/** \brief log2 of the number of sub-buckets per power of two */
+#define  HISTSUBBITS        6
+
+/** \brief number of sub-buckets per power of two */
+#define  HISTSUB            (1 << HISTSUBBITS)
+
+/** \brief number of buckets (covers every non negative long long) */
+#define  HISTBUCKETS        (HISTSUB * (64 - HISTSUBBITS + 1))
+
+/**
+ *  \brief Definition of a histogram.
+ */
+typedef struct {
+    /** \brief number of values in each bucket */
+    unsigned int count[HISTBUCKETS];
+    /** \brief number of values recorded */
+    long long n;
+    /** \brief smallest value recorded */
+    long long min;
+    /** \brief largest value recorded */
+    long long max;
+    /** \brief sum of the values recorded */
+    double sum;
+} HISTOGRAM;
+
+/**
+ *  \brief Initialization of a histogram.
+ *
+ *  \param h pointer to the histogram
+ */
+extern void histInit (HISTOGRAM *h);
+
+/**
+ *  \brief Recording a value.
+ *
+ *  Negative values are recorded as 0.
+ *
+ *  \param h pointer to the histogram
+ *  \param v value
+ */
+extern void histRecord (HISTOGRAM *h, long long v);
+
+/**
+ *  \brief Merging a histogram into another.
+ *
+ *  \param h pointer to the histogram that receives the values
+ *  \param o pointer to the histogram whose values are added
+ */
+extern void histMerge (HISTOGRAM *h, const HISTOGRAM *o);
+
+/**
+ *  \brief Percentile of the recorded values.
+ *
+ *  The value returned is the middle of the bucket where the percentile falls, clamped to the
+ *  smallest and largest values recorded.
+ *
+ *  \param h pointer to the histogram
+ *  \param p percentile (0 .. 100)
+ *
+ *  \return value of the percentile (0 for an empty histogram)
+ */
+extern long long histPercentile (HISTOGRAM *h, double p);
+
+#endif /* HISTOGRAM_H_ */
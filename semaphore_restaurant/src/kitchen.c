@@ -0,0 +1,137 @@
+/**
+ *  \file kitchen.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Queues of the stations of the kitchen pipeline.
+ *
+ *  Defined operations:
+ *     \li initialization of the stations
+ *     \li insertion of an order in the queue of a station
+ *     \li removal of the next order from the queue of a station
+ *     \li name of a station.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "orderQueue.h"
+#include "kitchen.h"
+
+/* internal functions */
+
+/** \brief change of the number of orders in the queue of a station, with the integral of the depth */
+static void depthChange (STATION *st, int delta, long long now)
+{
+    if (st->lastChange != 0) {
+        st->depthUsage += st->count * (now - st->lastChange);
+    }
+    st->lastChange = now;
+    st->count += delta;
+    if (st->count > st->maxCount) {
+        st->maxCount = st->count;
+    }
+}
+
+/* external functions */
+
+/**
+ *  \brief Initialization of the stations.
+ *
+ *  All queues become empty. The number of workers, the capacity and the time per portion must have been set.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+void stationInit (FULL_STAT *p_fSt)
+{
+    int s, w;
+
+    for (s = 0; s < NSTATIONS; s++) {
+        STATION *st = &p_fSt->station[s];
+
+        st->head = st->count = st->taken = st->maxCount = 0;
+        st->lastChange = st->depthUsage = st->busy = st->blocked = 0;
+        for (w = 0; w < MAXWORKERS; w++) {
+            st->pid[w] = 0;
+        }
+    }
+    p_fSt->station[ST_PREP].capacity = p_fSt->orderQueueSize;
+}
+
+/**
+ *  \brief Insertion of an order in the queue of a station.
+ *
+ *  The queue must not be full.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param s station (ST_PREP .. ST_PLATE)
+ *  \param order order
+ *  \param now present time stamp (us)
+ */
+void stationPush (FULL_STAT *p_fSt, int s, ORDER order, long long now)
+{
+    STATION *st = &p_fSt->station[s];
+
+    int i;
+
+    if (s == ST_PREP) {
+        orderEnqueue (p_fSt, order.group, order.deadline, order.payload);
+    }
+    else {
+        i = st->count;
+        if (p_fSt->kitchenPolicy == EDF) {                /* before the later deadlines, ties in arrival order */
+            for (; (i > 0) && (st->queue[(st->head + i - 1) % MAXORDERS].deadline > order.deadline); i--) {
+                st->queue[(st->head + i) % MAXORDERS] = st->queue[(st->head + i - 1) % MAXORDERS];
+            }
+        }
+        st->queue[(st->head + i) % MAXORDERS] = order;
+    }
+    depthChange (st, 1, now);
+}
+
+/**
+ *  \brief Removal of the next order from the queue of a station.
+ *
+ *  The queue must not be empty. The order is counted as taken by the workers of the station.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param s station (ST_PREP .. ST_PLATE)
+ *  \param now present time stamp (us)
+ *
+ *  \return order removed
+ */
+ORDER stationPop (FULL_STAT *p_fSt, int s, long long now)
+{
+    STATION *st = &p_fSt->station[s];
+    ORDER order;
+
+    if (s == ST_PREP) {
+        order = orderDequeue (p_fSt);
+    }
+    else {
+        order = st->queue[st->head];
+        st->head = (st->head + 1) % MAXORDERS;
+    }
+    depthChange (st, -1, now);
+    st->taken++;
+    return order;
+}
+
+/**
+ *  \brief Name of a station.
+ *
+ *  \param s station
+ *
+ *  \return printable name of the station
+ */
+const char *stationName (int s)
+{
+    switch (s) {
+        case ST_PREP:  return "prep";
+        case ST_COOK:  return "cook";
+        case ST_PLATE: return "plate";
+    }
+    return "unknown";
+}
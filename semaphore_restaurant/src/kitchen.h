@@ -0,0 +1,70 @@
+/**
+ *  \file kitchen.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Queues of the stations of the kitchen pipeline.
+ *
+ *  Defined operations:
+ *     \li initialization of the stations
+ *     \li insertion of an order in the queue of a station
+ *     \li removal of the next order from the queue of a station
+ *     \li name of a station.
+ *
+ *  The queue of the first station (ST_PREP) is the kitchen order queue, ordered by the kitchen scheduling policy
+ *  (see orderQueue.h); the queues of the other stations keep the orders in arrival order too, or in deadline order
+ *  under EDF, so that an urgent order does not lose its place at the later stations. The depth of every queue
+ *  is integrated over time, for the report. The room in the queues is counted by semaphores, so a worker blocks
+ *  before inserting into a full queue and back-pressure propagates upstream, up to the waiter.
+ *  The operations must be called within the critical region.
+ */
+
+#ifndef KITCHEN_H_
+#define KITCHEN_H_
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Initialization of the stations.
+ *
+ *  All queues become empty. The number of workers, the capacity and the time per portion must have been set.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+extern void stationInit (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Insertion of an order in the queue of a station.
+ *
+ *  The queue must not be full.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param s station (ST_PREP .. ST_PLATE)
+ *  \param order order
+ *  \param now present time stamp (us)
+ */
+extern void stationPush (FULL_STAT *p_fSt, int s, ORDER order, long long now);
+
+/**
+ *  \brief Removal of the next order from the queue of a station.
+ *
+ *  The queue must not be empty. The order is counted as taken by the workers of the station.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param s station (ST_PREP .. ST_PLATE)
+ *  \param now present time stamp (us)
+ *
+ *  \return order removed
+ */
+extern ORDER stationPop (FULL_STAT *p_fSt, int s, long long now);
+
+/**
+ *  \brief Name of a station.
+ *
+ *  \param s station
+ *
+ *  \return printable name of the station
+ */
+extern const char *stationName (int s);
+
+#endif /* KITCHEN_H_ */
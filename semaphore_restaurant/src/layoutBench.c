@@ -0,0 +1,343 @@
+/**
+ *  \file layoutBench.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  Benchmark of the layout of the shared region.
+ *
+ *  Several processes, each playing an intervening entity (chef, waiter, receptionist, groups), repeatedly do what
+ *  the entities do to the shared region on every step, each touching only the fields it owns: read the mutex id,
+ *  change their own state (staff), bump the sequence counter (chef) and stamp their own lifecycle record (groups).
+ *  No field is written by two processes, so any cost a layout adds over the other comes from false sharing. The
+ *  request slots and the byte-sized group states are left out: they are written by several entities, but only
+ *  within the critical region. The loop runs twice, once over the hot fields laid out as they used to be (packed
+ *  together) and once over the present SHARED_DATA, where independently written fields sit on separate cache lines.
+ *
+ *  For each layout the CPU time per step and, where the kernel and the machine expose them (perf_event_open), the
+ *  hardware cache misses and the L1 data cache load misses per step are printed in CSV and saved as JSON.
+ *  False sharing only shows with the processes running on different cores.
+ *
+ *  Usage: layoutBench [-n iterations] [-p processes] [-o report]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/wait.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "sharedMemory.h"
+
+/** \brief default number of steps of each process */
+#define  DEFITER            1000000
+
+/** \brief default number of processes (chef, waiter, receptionist and one group) */
+#define  DEFPROC            4
+
+/** \brief maximum number of processes (one per usage slot) */
+#define  MAXPROC            NUSAGE
+
+/** \brief number of layouts */
+#define  NLAYOUTS           2
+
+/** \brief number of hardware counters */
+#define  NCOUNTERS          2
+
+/** \brief names of the layouts */
+static const char *layoutName[NLAYOUTS] = { "packed", "aligned" };
+
+/** \brief names of the hardware counters */
+static const char *counterName[NCOUNTERS] = { "cache_misses", "l1d_load_misses" };
+
+/**
+ *  \brief Hot fields of the shared region as they were laid out before the cache line alignment
+ */
+typedef struct {
+    unsigned int receptionistStat, waiterStat, chefStat, groupStat[MAXGROUPS];
+    request receptionistRequest, waiterRequest;
+    struct { long long arrival; long long enter[LEAVING+1]; } life[MAXGROUPS];
+    unsigned int seq, mutex;
+} PACKED;
+
+/** \brief fields a process touches on every step */
+typedef struct {
+    unsigned int *mutex,                                                          /* semaphore id, read on every step */
+                 *state,                                                  /* own state (staff only, or NULL) */
+                 *seq;                                                    /* sequence counter (chef only, or NULL) */
+    long long *stamp;                                     /* own lifecycle record (groups, previous layout, or NULL) */
+    uint32_t *stamp32;                                        /* own time stamps (groups, present layout, or NULL) */
+} HOT;
+
+/** \brief measurements of a process */
+typedef struct {
+    long long ns;                                                                   /* CPU time of the loop */
+    long long count[NCOUNTERS];                                               /* hardware counters (-1 if n/a) */
+} RESULT;
+
+/** \brief region shared by the processes */
+typedef struct {
+    SHARED_DATA aligned;                                                                      /* present layout */
+    PACKED packed CACHEALIGNED;                                                               /* previous layout */
+    int ready CACHEALIGNED;                                                   /* processes ready to start a loop */
+    RESULT res[NLAYOUTS][MAXPROC];                                                        /* measurements */
+} REGION;
+
+/** \brief number of steps of each process */
+static int nIter = DEFITER;
+
+/** \brief number of processes */
+static int nProc = DEFPROC;
+
+/* internal functions */
+
+/** \brief CPU time (ns) of this process (the processes may share cores, so wall time would mislead) */
+static long long cpuNowNs (void)
+{
+    struct timespec ts;
+
+    clock_gettime (CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/** \brief opening a hardware counter of this process (-1 if unavailable) */
+static int counterOpen (int c)
+{
+    struct perf_event_attr attr;
+
+    memset (&attr, 0, sizeof (attr));
+    attr.size = sizeof (attr);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    if (c == 0) {
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    }
+    else {
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+    return (int) syscall (SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+/** \brief fields touched by process p (entity slot p) in the previous layout */
+static void hotPacked (PACKED *l, int p, HOT *h)
+{
+    h->mutex = &l->mutex;
+    h->seq = (p == U_CHEF) ? &l->seq : NULL;
+    h->stamp = (p >= U_GROUP) ? l->life[p-U_GROUP].enter : NULL;
+    h->stamp32 = NULL;
+    switch (p) {
+        case U_CHEF:         h->state = &l->chefStat;
+                             break;
+        case U_WAITER:       h->state = &l->waiterStat;
+                             break;
+        case U_RECEPTIONIST: h->state = &l->receptionistStat;
+                             break;
+        default:             h->state = NULL;
+    }
+}
+
+/** \brief fields touched by process p (entity slot p) in the present layout */
+static void hotAligned (SHARED_DATA *sh, int p, HOT *h)
+{
+    h->mutex = &sh->mutex;
+    h->seq = (p == U_CHEF) ? &sh->seq : NULL;
+    h->stamp = NULL;
+    h->stamp32 = (p >= U_GROUP) ? sh->fSt.groupTimes[p-U_GROUP].t : NULL;
+    switch (p) {
+        case U_CHEF:         h->state = &sh->fSt.st.chefStat;
+                             break;
+        case U_WAITER:       h->state = &sh->fSt.st.waiterStat;
+                             break;
+        case U_RECEPTIONIST: h->state = &sh->fSt.st.receptionistStat;
+                             break;
+        default:             h->state = NULL;
+    }
+}
+
+/** \brief the steps of a process over one layout */
+static void loop (REGION *r, int layout, int p)
+{
+    volatile unsigned int sink = 0;
+    RESULT *res = &r->res[layout][p];
+    int fd[NCOUNTERS], c, i;
+    long long t0;
+    HOT h;
+
+    if (layout == 0) {
+        hotPacked (&r->packed, p, &h);
+    }
+    else hotAligned (&r->aligned, p, &h);
+    for (c = 0; c < NCOUNTERS; c++) {
+        fd[c] = counterOpen (c);
+    }
+
+    __atomic_fetch_add (&r->ready, 1, __ATOMIC_ACQ_REL);                               /* all processes start together */
+    while (__atomic_load_n (&r->ready, __ATOMIC_ACQUIRE) < nProc) {
+        sched_yield ();
+    }
+    for (c = 0; c < NCOUNTERS; c++) {
+        if (fd[c] != -1) {
+            ioctl (fd[c], PERF_EVENT_IOC_RESET, 0);
+            ioctl (fd[c], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    t0 = cpuNowNs ();
+    for (i = 0; i < nIter; i++) {
+        sink += __atomic_load_n (h.mutex, __ATOMIC_RELAXED);
+        if (h.state != NULL) {
+            __atomic_store_n (h.state, (unsigned int) i, __ATOMIC_RELAXED);
+        }
+        if (h.seq != NULL) {
+            __atomic_store_n (h.seq, *h.seq + 1, __ATOMIC_RELEASE);
+        }
+        if (h.stamp != NULL) {
+            __atomic_store_n (&h.stamp[i & LEAVING], (long long) i, __ATOMIC_RELAXED);
+        }
+        else if (h.stamp32 != NULL) {
+            __atomic_store_n (&h.stamp32[i & LEAVING], (uint32_t) i, __ATOMIC_RELAXED);
+        }
+    }
+    res->ns = cpuNowNs () - t0;
+    for (c = 0; c < NCOUNTERS; c++) {
+        res->count[c] = -1;
+        if (fd[c] != -1) {
+            ioctl (fd[c], PERF_EVENT_IOC_DISABLE, 0);
+            if (read (fd[c], &res->count[c], sizeof (long long)) != sizeof (long long)) {
+                res->count[c] = -1;
+            }
+            close (fd[c]);
+        }
+    }
+}
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to run the processes over each layout and report the measurements.
+ */
+int main (int argc, char *argv[])
+{
+    char *nRep = "layoutBench.json";                                                    /* name of the report file */
+    double ns[NLAYOUTS], count[NLAYOUTS][NCOUNTERS];
+    int shmid, status, pid[MAXPROC], l, p, c, opt;
+    REGION *r;
+    FILE *fp;
+
+    while ((opt = getopt (argc, argv, "n:p:o:")) != -1) {
+        switch (opt) {
+            case 'n': nIter = atoi (optarg);
+                      break;
+            case 'p': nProc = atoi (optarg);
+                      break;
+            case 'o': nRep = optarg;
+                      break;
+            default:  fprintf (stderr, "Usage: %s [-n iterations] [-p processes] [-o report]\n", argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if ((nIter < 1) || (nProc < 1) || (nProc > MAXPROC)) {
+        fprintf (stderr, "Usage: %s [-n iterations (> 0)] [-p processes (1 .. %d)] [-o report]\n", argv[0], MAXPROC);
+        exit (EXIT_FAILURE);
+    }
+
+    if ((shmid = shmemCreate (IPC_PRIVATE, sizeof (REGION))) == -1) {
+        perror ("error on creating the shared memory region");
+        exit (EXIT_FAILURE);
+    }
+    if (shmemAttach (shmid, (void **) &r) == -1) {
+        perror ("error on mapping the shared region on the process address space");
+        shmemDestroy (shmid);
+        exit (EXIT_FAILURE);
+    }
+    memset (r, 0, sizeof (REGION));
+
+    for (l = 0; l < NLAYOUTS; l++) {
+        r->ready = 0;
+        for (p = 0; p < nProc; p++) {
+            if ((pid[p] = fork ()) < 0) {
+                perror ("error on the fork operation for a process");
+                shmemDestroy (shmid);
+                exit (EXIT_FAILURE);
+            }
+            if (pid[p] == 0) {
+                loop (r, l, p);
+                exit (EXIT_SUCCESS);
+            }
+        }
+        for (p = 0; p < nProc; p++) {
+            if ((waitpid (pid[p], &status, 0) == -1) || !WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+                fprintf (stderr, "error on a process\n");
+                shmemDestroy (shmid);
+                exit (EXIT_FAILURE);
+            }
+        }
+        ns[l] = 0.0;
+        for (c = 0; c < NCOUNTERS; c++) {
+            count[l][c] = 0.0;
+        }
+        for (p = 0; p < nProc; p++) {
+            ns[l] += (double) r->res[l][p].ns / nIter / nProc;
+            for (c = 0; c < NCOUNTERS; c++) {
+                count[l][c] = ((count[l][c] < 0.0) || (r->res[l][p].count[c] < 0)) ? -1.0
+                              : count[l][c] + (double) r->res[l][p].count[c] / nIter / nProc;
+            }
+        }
+    }
+
+    /* results per step, averaged over the processes */
+    printf ("layout,processes,cpu_ns_per_step");
+    for (c = 0; c < NCOUNTERS; c++) {
+        printf (",%s_per_step", counterName[c]);
+    }
+    printf ("\n");
+    for (l = 0; l < NLAYOUTS; l++) {
+        printf ("%s,%d,%.2f", layoutName[l], nProc, ns[l]);
+        for (c = 0; c < NCOUNTERS; c++) {
+            if (count[l][c] < 0.0) {
+                printf (",n/a");
+            }
+            else printf (",%.4f", count[l][c]);
+        }
+        printf ("\n");
+    }
+
+    if ((fp = fopen (nRep, "w")) == NULL) {
+        perror ("error on creating the report file");
+        exit (EXIT_FAILURE);
+    }
+    fprintf (fp, "{\n  \"iterations\": %d,\n  \"processes\": %d,\n  \"cache_line\": %d,\n  \"layouts\": [\n",
+             nIter, nProc, CACHELINE);
+    for (l = 0; l < NLAYOUTS; l++) {
+        fprintf (fp, "    {\"name\": \"%s\", \"cpu_ns_per_step\": %.2f", layoutName[l], ns[l]);
+        for (c = 0; c < NCOUNTERS; c++) {
+            if (count[l][c] < 0.0) {
+                fprintf (fp, ", \"%s_per_step\": null", counterName[c]);
+            }
+            else fprintf (fp, ", \"%s_per_step\": %.4f", counterName[c], count[l][c]);
+        }
+        fprintf (fp, "}%s\n", (l < NLAYOUTS - 1) ? "," : "");
+    }
+    fprintf (fp, "  ]\n}\n");
+    fclose (fp);
+
+    if ((shmemDettach (r) == -1) || (shmemDestroy (shmid) == -1)) {
+        perror ("error on destructing the shared region");
+        exit (EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,97 @@
+/**
+ *  \file lifecycle.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Phases of the lifecycle of a group.
+ *
+ *  Defined operations:
+ *     \li name of a phase
+ *     \li latency of a phase for a given group
+ *     \li recording of the latencies of a visit that ends.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "lifecycle.h"
+
+/** \brief names of the phases */
+static const char *phaseNames[NPHASES] = { "reception", "table", "order", "kitchen", "delivery", "checkout", "total" };
+
+/* internal functions */
+
+/** \brief interval between two time stamps, -1 if any of them was not taken */
+static long long interval (long long from, long long to)
+{
+    return ((from != 0) && (to != 0)) ? to - from : -1;
+}
+
+/* external functions */
+
+/**
+ *  \brief Name of a phase.
+ *
+ *  \param ph phase (0 .. NPHASES-1)
+ *
+ *  \return name of the phase
+ */
+const char *phaseName (int ph)
+{
+    return ((ph >= 0) && (ph < NPHASES)) ? phaseNames[ph] : "unknown";
+}
+
+/**
+ *  \brief Latency of a phase for a given group.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param ph phase (0 .. NPHASES-1)
+ *
+ *  \return latency (us), or -\c 1 if the group did not go through the phase (e.g. it was turned away)
+ */
+long long phaseLatency (FULL_STAT *p_fSt, int g, int ph)
+{
+    switch (ph) {
+        case PH_RECEPTION: return interval (groupTime (p_fSt, g, T_ARRIVAL), groupTime (p_fSt, g, ATRECEPTION));
+        case PH_TABLE:     return interval (groupTime (p_fSt, g, ATRECEPTION), groupTime (p_fSt, g, FOOD_REQUEST));
+        case PH_ORDER:     return interval (groupTime (p_fSt, g, FOOD_REQUEST), groupTime (p_fSt, g, WAIT_FOR_FOOD));
+        case PH_KITCHEN:   return interval (groupTime (p_fSt, g, T_ORDER), groupTime (p_fSt, g, T_READY));
+        case PH_DELIVERY:  return interval (groupTime (p_fSt, g, T_READY), groupTime (p_fSt, g, EAT));
+        case PH_CHECKOUT:  return interval (groupTime (p_fSt, g, CHECKOUT), groupTime (p_fSt, g, LEAVING));
+        case PH_TOTAL:     return (groupTime (p_fSt, g, EAT) != 0) ? interval (groupTime (p_fSt, g, T_ARRIVAL),
+                                                                               groupTime (p_fSt, g, LEAVING)) : -1;
+        default:           return -1;
+    }
+}
+
+/**
+ *  \brief Recording of the latencies of a visit that ends.
+ *
+ *  The latency of every phase the group went through and, if it ordered, the tardiness of its food are added to
+ *  the per-visit measurements of the full state. Must be called within the critical region, once the group is
+ *  LEAVING.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ */
+void visitRecord (FULL_STAT *p_fSt, int g)
+{
+    long long lat, ready;
+    int ph;
+
+    for (ph = 0; ph < NPHASES; ph++) {
+        if ((lat = phaseLatency (p_fSt, g, ph)) != -1) {
+            histRecord (&p_fSt->visitPhase[ph], lat);
+        }
+    }
+    if ((ready = groupTime (p_fSt, g, T_READY)) != 0) {                /* groups turned away never order */
+        lat = ready - groupTime (p_fSt, g, T_DEADLINE);
+        histRecord (&p_fSt->visitTardiness, (lat > 0) ? lat : 0);
+        if (lat > 0) {
+            p_fSt->visitMissed++;
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/**
+ *  \file lifecycle.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Phases of the lifecycle of a group.
+ *
+ *  Defined operations:
+ *     \li name of a phase
+ *     \li latency of a phase for a given group
+ *     \li recording of the latencies of a visit that ends.
+ *
+ *  Latencies are computed from the time stamps kept in the full state: the lifecycle record stamped by
+ *  each group on its state transitions and the order and ready time stamps of the waiter and the chef.
+ *  The stamps describe the present (or last) visit of each group, so every visit records its latencies in
+ *  the full state as it ends; other than that, they must be read after all intervening entities have
+ *  terminated.
+ */
+
+#ifndef LIFECYCLE_H_
+#define LIFECYCLE_H_
+
+#include "probDataStruct.h"
+
+/* the phases (PH_RECEPTION .. PH_TOTAL, NPHASES) are defined in probDataStruct.h */
+
+/**
+ *  \brief Name of a phase.
+ *
+ *  \param ph phase (0 .. NPHASES-1)
+ *
+ *  \return name of the phase
+ */
+extern const char *phaseName (int ph);
+
+/**
+ *  \brief Latency of a phase for a given group.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param ph phase (0 .. NPHASES-1)
+ *
+ *  \return latency (us), or -\c 1 if the group did not go through the phase (e.g. it was turned away)
+ */
+extern long long phaseLatency (FULL_STAT *p_fSt, int g, int ph);
+
+/**
+ *  \brief Recording of the latencies of a visit that ends.
+ *
+ *  The latency of every phase the group went through and, if it ordered, the tardiness of its food are added to
+ *  the per-visit measurements of the full state. Must be called within the critical region, once the group is
+ *  LEAVING.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ */
+extern void visitRecord (FULL_STAT *p_fSt, int g);
+
+#endif /* LIFECYCLE_H_ */
@@ -0,0 +1,421 @@
+/**
+ *  \file logCheck.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  Streaming analyzer of state logs.
+ *
+ *  Reads the logs written by the launcher (see logging.c) in a single pass and checks, on every line, the
+ *  invariants of the problem:
+ *     \li every state is in range and every table id is below NUMTABLES
+ *     \li at most NUMTABLES tables are occupied
+ *     \li no table is assigned to two groups
+ *     \li a table is only held by a group between the reception and the checkout
+ *     \li the number of groups in the waiting room does not exceed the groups at the reception without a table
+ *     \li every group ends LEAVING.
+ *
+ *  A file may hold several runs, each one starting at a header line. Besides the violations, the number of
+ *  state changes, visits served and turned away, table occupancy and waiting room length of every run are
+ *  summarized. A visit ends each time a group goes into LEAVING, and it was served if the group held a table
+ *  since it last went back to GOTOREST, so that the groups that come back in the continuous mode are counted
+ *  once per visit. The logs carry no time stamps, so throughput is given per state change (and the analyzer reports
+ *  its own, in lines and bytes per second).
+ *
+ *  The files are shared out dynamically among a pool of worker processes.
+ *
+ *  Usage: logCheck [-j workers] file ...
+ *
+ *  The exit status is EXIT_FAILURE if any file could not be read or violates an invariant.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/wait.h>
+
+#include "probConst.h"
+#include "sharedMemory.h"
+#include "timing.h"
+
+/** \brief maximum length of a line of the log (a few columns per group) */
+#define  LINELEN            (1024 + 16 * MAXGROUPS)
+
+/** \brief size of the stream buffer of each file */
+#define  BUFSIZE            (1 << 20)
+
+/** \brief maximum length of the description of a violation */
+#define  MSGLEN             160
+
+/** \brief table id of a group without a table */
+#define  NOTABLE            -1
+
+/* invariants checked */
+/** \brief malformed line */
+#define  C_FORMAT           0
+/** \brief state or table id out of range */
+#define  C_RANGE            1
+/** \brief more than NUMTABLES tables occupied */
+#define  C_OCCUPIED         2
+/** \brief a table assigned to two groups */
+#define  C_TWICE            3
+/** \brief a table held outside the reception .. checkout states */
+#define  C_HOLDER           4
+/** \brief waiting room larger than the groups at the reception without a table */
+#define  C_WAITING          5
+/** \brief a group not LEAVING at the end of the run */
+#define  C_LEAVING          6
+/** \brief number of invariants */
+#define  NCHECKS            7
+
+/** \brief names of the invariants */
+static const char *checkName[NCHECKS] = { "malformed line", "out of range", "tables occupied", "table assigned twice",
+                                          "table holder", "groupsWaiting", "not LEAVING at end" };
+
+/**
+ *  \brief Results of a file (shared memory region, one entry per file)
+ */
+typedef struct {
+    bool read;                                                                           /* the file could be read */
+    int runs;                                                                                    /* number of runs */
+    long long lines,                                                                  /* number of state changes */
+              bytes;                                                                      /* size of the file */
+    long long served,                                                        /* visits that got a table, all runs */
+              rejected;                                                    /* visits that ended without one, all runs */
+    int peakTables,                                                                /* largest number of occupied tables */
+        peakWaiting;                                                              /* longest waiting room */
+    long long tableSum;                                         /* occupied tables summed over all state changes */
+    long long violations[NCHECKS];                                               /* number of violations of each check */
+    char first[MSGLEN];                                                       /* description of the first violation */
+} FILERESULT;
+
+/** \brief state of the run being analyzed */
+typedef struct {
+    int nGroups;                                                                  /* number of groups (0 - no run) */
+    long long lineNo;                                                          /* line number of the last state line */
+    bool seated[MAXGROUPS];                                             /* the group got a table in its present visit */
+    unsigned int state[MAXGROUPS];                                                      /* last state of each group */
+} RUNSTATE;
+
+/* internal functions */
+
+/** \brief recording a violation */
+static void violation (FILERESULT *r, int check, const char *file, long long lineNo, const char *what)
+{
+    r->violations[check] += 1;
+    if (r->first[0] == '\0') {
+        snprintf (r->first, MSGLEN, "%s:%lld: %s (%s)", file, lineNo, checkName[check], what);
+    }
+}
+
+/** \brief end of a run: every group must be LEAVING (visits still going on are not counted) */
+static void endRun (FILERESULT *r, RUNSTATE *run, const char *file)
+{
+    char what[MSGLEN];
+    int g;
+
+    if (run->nGroups == 0) {
+        return;
+    }
+    for (g = 0; g < run->nGroups; g++) {
+        if (run->state[g] != LEAVING) {
+            snprintf (what, MSGLEN, "group %d ends in state %u", g, run->state[g]);
+            violation (r, C_LEAVING, file, run->lineNo, what);
+        }
+    }
+    run->nGroups = 0;
+}
+
+/** \brief start of a run: the header line names the groups (G00 G01 ...) */
+static void startRun (RUNSTATE *run, char *line)
+{
+    char *tok;
+    int n = 0;
+
+    for (tok = strtok (line, " \t\r\n"); tok != NULL; tok = strtok (NULL, " \t\r\n")) {
+        if ((tok[0] == 'G') && (tok[1] >= '0') && (tok[1] <= '9')) {
+            n++;
+        }
+    }
+    memset (run, 0, sizeof (RUNSTATE));
+    run->nGroups = (n <= MAXGROUPS) ? n : MAXGROUPS;
+}
+
+/** \brief next integer field of a state line ('.' stands for no table); false at the end of the line */
+static bool nextField (char **p, int *v)
+{
+    char *s = *p;
+    int sign = 1;
+
+    while ((*s == ' ') || (*s == '\t')) {
+        s++;
+    }
+    if (*s == '.') {
+        *v = NOTABLE;
+        *p = s + 1;
+        return true;
+    }
+    if (*s == '-') {
+        sign = -1;
+        s++;
+    }
+    if ((*s < '0') || (*s > '9')) {
+        return false;
+    }
+    for (*v = 0; (*s >= '0') && (*s <= '9'); s++) {
+        *v = *v * 10 + (*s - '0');
+    }
+    *v *= sign;
+    *p = s;
+    return true;
+}
+
+/** \brief checking a state line */
+static void checkLine (FILERESULT *r, RUNSTATE *run, char *line, const char *file)
+{
+    int ent[3], st[MAXGROUPS], tab[MAXGROUPS], owner[NUMTABLES];
+    int waiting, atReception = 0, occupied = 0, g, t, i, v;
+    char what[MSGLEN], *p = line;
+
+    for (i = 0; i < 3; i++) {
+        if (!nextField (&p, &ent[i])) {
+            violation (r, C_FORMAT, file, run->lineNo, "entity states");
+            return;
+        }
+    }
+    for (g = 0; g < run->nGroups; g++) {
+        if (!nextField (&p, &st[g])) {
+            violation (r, C_FORMAT, file, run->lineNo, "group states");
+            return;
+        }
+    }
+    if (!nextField (&p, &waiting)) {
+        violation (r, C_FORMAT, file, run->lineNo, "groupsWaiting");
+        return;
+    }
+    for (g = 0; g < run->nGroups; g++) {
+        if (!nextField (&p, &tab[g])) {
+            violation (r, C_FORMAT, file, run->lineNo, "tables");
+            return;
+        }
+    }
+    if (nextField (&p, &v)) {
+        violation (r, C_FORMAT, file, run->lineNo, "extra fields");
+        return;
+    }
+
+    for (i = 0; i < 3; i++) {
+        if ((ent[i] < 0) || (ent[i] > 2)) {
+            snprintf (what, MSGLEN, "entity %d in state %d", i, ent[i]);
+            violation (r, C_RANGE, file, run->lineNo, what);
+        }
+    }
+    for (t = 0; t < NUMTABLES; t++) {
+        owner[t] = -1;
+    }
+    for (g = 0; g < run->nGroups; g++) {
+        if ((st[g] < GOTOREST) || (st[g] > LEAVING)) {
+            snprintf (what, MSGLEN, "group %d in state %d", g, st[g]);
+            violation (r, C_RANGE, file, run->lineNo, what);
+        }
+        if ((st[g] != LEAVING) && (run->state[g] == LEAVING)) {       /* back to GOTOREST: a new visit starts */
+            run->seated[g] = false;
+        }
+        if ((st[g] == LEAVING) && (run->state[g] != LEAVING)) {                /* the visit ends */
+            if (run->seated[g]) {
+                r->served += 1;
+            }
+            else r->rejected += 1;
+        }
+        run->state[g] = (unsigned int) st[g];
+        if (tab[g] == NOTABLE) {
+            atReception += (st[g] == ATRECEPTION);
+            continue;
+        }
+        if ((tab[g] < 0) || (tab[g] >= NUMTABLES)) {
+            snprintf (what, MSGLEN, "group %d at table %d", g, tab[g]);
+            violation (r, C_RANGE, file, run->lineNo, what);
+            continue;
+        }
+        run->seated[g] = true;
+        if ((st[g] < ATRECEPTION) || (st[g] > CHECKOUT)) {
+            snprintf (what, MSGLEN, "group %d holds table %d in state %d", g, tab[g], st[g]);
+            violation (r, C_HOLDER, file, run->lineNo, what);
+        }
+        if (owner[tab[g]] != -1) {
+            snprintf (what, MSGLEN, "table %d held by groups %d and %d", tab[g], owner[tab[g]], g);
+            violation (r, C_TWICE, file, run->lineNo, what);
+        }
+        else {
+            owner[tab[g]] = g;
+            occupied += 1;
+        }
+    }
+    if (occupied > NUMTABLES) {
+        snprintf (what, MSGLEN, "%d tables", occupied);
+        violation (r, C_OCCUPIED, file, run->lineNo, what);
+    }
+    if ((waiting < 0) || (waiting > atReception)) {
+        snprintf (what, MSGLEN, "%d waiting, %d at the reception without a table", waiting, atReception);
+        violation (r, C_WAITING, file, run->lineNo, what);
+    }
+
+    r->lines += 1;
+    r->tableSum += occupied;
+    if (occupied > r->peakTables) {
+        r->peakTables = occupied;
+    }
+    if (waiting > r->peakWaiting) {
+        r->peakWaiting = waiting;
+    }
+}
+
+/** \brief analyzing a file in a single pass */
+static void checkFile (const char *file, FILERESULT *r)
+{
+    static char buf[BUFSIZE];
+    char line[LINELEN], *s;
+    RUNSTATE run = { 0 };
+    long long lineNo = 0;
+    FILE *fp;
+
+    memset (r, 0, sizeof (FILERESULT));
+    if ((fp = fopen (file, "r")) == NULL) {
+        return;
+    }
+    setvbuf (fp, buf, _IOFBF, BUFSIZE);
+    r->read = true;
+    while (fgets (line, LINELEN, fp) != NULL) {
+        lineNo += 1;
+        r->bytes += strlen (line);
+        s = line + strspn (line, " ");
+        if ((*s >= '0') && (*s <= '9') && (run.nGroups > 0)) {                                /* a state line */
+            run.lineNo = lineNo;
+            checkLine (r, &run, line, file);
+        }
+        else if (strncmp (s, "CH ", 3) == 0) {                                        /* a header: a new run begins */
+            endRun (r, &run, file);
+            startRun (&run, line);
+            run.lineNo = lineNo;
+            r->runs += 1;
+        }
+    }
+    endRun (r, &run, file);
+    fclose (fp);
+}
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to generate the workers, wait for them to analyze every file and print the results.
+ */
+int main (int argc, char *argv[])
+{
+    FILERESULT *res;                                                  /* results of each file (shared memory region) */
+    int *next;                                                           /* next file to be analyzed (shared counter) */
+    int nWorkers = (int) sysconf (_SC_NPROCESSORS_ONLN), nFiles, shmid, status, w, f, c, opt, nBad = 0;
+    long long t0, elapsed, lines = 0, bytes = 0, served = 0, rejected = 0, tableSum = 0, viol[NCHECKS] = { 0 };
+    int runs = 0, peakTables = 0, peakWaiting = 0;
+    pid_t pid;
+
+    while ((opt = getopt (argc, argv, "j:")) != -1) {
+        switch (opt) {
+            case 'j': nWorkers = atoi (optarg);
+                      break;
+            default:  fprintf (stderr, "Usage: %s [-j workers] file ...\n", argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if ((nWorkers < 1) || (optind == argc)) {
+        fprintf (stderr, "Usage: %s [-j workers] file ...\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+    nFiles = argc - optind;
+    if (nWorkers > nFiles) {
+        nWorkers = nFiles;
+    }
+
+    /* the results and the counter of the next file live in a private region inherited by the workers */
+    if ((shmid = shmemCreate (IPC_PRIVATE, sizeof (int) + nFiles * sizeof (FILERESULT))) == -1) {
+        perror ("error on creating the shared memory region");
+        exit (EXIT_FAILURE);
+    }
+    if (shmemAttach (shmid, (void **) &next) == -1) {
+        perror ("error on mapping the shared region on the process address space");
+        shmemDestroy (shmid);
+        exit (EXIT_FAILURE);
+    }
+    res = (FILERESULT *) (next + 1);
+    *next = 0;
+
+    t0 = timeNow ();
+    for (w = 0; w < nWorkers; w++) {
+        if ((pid = fork ()) < 0) {
+            perror ("error on the fork operation for a worker");
+            shmemDestroy (shmid);
+            exit (EXIT_FAILURE);
+        }
+        if (pid == 0) {
+            while ((f = __atomic_fetch_add (next, 1, __ATOMIC_RELAXED)) < nFiles) {
+                checkFile (argv[optind+f], &res[f]);
+            }
+            exit (EXIT_SUCCESS);
+        }
+    }
+    for (w = 0; w < nWorkers; w++) {
+        if ((wait (&status) == -1) || !WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+            fprintf (stderr, "a worker failed\n");
+            nBad += 1;
+        }
+    }
+    elapsed = timeNow () - t0;
+
+    /* results of each file with violations, then the totals */
+    for (f = 0; f < nFiles; f++) {
+        if (!res[f].read) {
+            fprintf (stderr, "%s: could not be read\n", argv[optind+f]);
+            nBad += 1;
+            continue;
+        }
+        if (res[f].first[0] != '\0') {
+            printf ("%s\n", res[f].first);
+            nBad += 1;
+        }
+        runs += res[f].runs;
+        lines += res[f].lines;
+        bytes += res[f].bytes;
+        served += res[f].served;
+        rejected += res[f].rejected;
+        tableSum += res[f].tableSum;
+        peakTables = (res[f].peakTables > peakTables) ? res[f].peakTables : peakTables;
+        peakWaiting = (res[f].peakWaiting > peakWaiting) ? res[f].peakWaiting : peakWaiting;
+        for (c = 0; c < NCHECKS; c++) {
+            viol[c] += res[f].violations[c];
+        }
+    }
+
+    printf ("\n%d files, %d runs, %lld state changes (%.1f MB in %.3f s: %.0f lines/s, %.1f MB/s, %d workers)\n",
+            nFiles, runs, lines, bytes / 1e6, elapsed / 1e6, (elapsed > 0) ? lines * 1e6 / elapsed : 0.0,
+            (elapsed > 0) ? (double) bytes / elapsed : 0.0, nWorkers);
+    printf ("visits             : %lld served, %lld turned away, %.1f served per run\n", served, rejected,
+            (runs > 0) ? (double) served / runs : 0.0);
+    printf ("state changes      : %.1f per run, %.1f per served visit\n", (runs > 0) ? (double) lines / runs : 0.0,
+            (served > 0) ? (double) lines / served : 0.0);
+    printf ("tables occupied    : %.2f on average over the state changes, peak %d of %d\n",
+            (lines > 0) ? (double) tableSum / lines : 0.0, peakTables, NUMTABLES);
+    printf ("waiting room       : peak %d groups\n", peakWaiting);
+    printf ("violations         :");
+    for (c = 0; c < NCHECKS; c++) {
+        printf (" %s %lld%s", checkName[c], viol[c], (c < NCHECKS - 1) ? "," : "\n");
+    }
+
+    if ((shmemDettach (next) == -1) || (shmemDestroy (shmid) == -1)) {
+        perror ("error on destructing the shared region");
+        exit (EXIT_FAILURE);
+    }
+
+    return (nBad > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
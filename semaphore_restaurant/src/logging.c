@@ -135,14 +135,14 @@ void saveState (char nFic[], FULL_STAT *p_fSt)
     fprintf(fic," ");
     int g;
     for(g=0; g < p_fSt->nGroups; g++) {
-        fprintf(fic,"%4d",p_fSt->st.groupStat[g]);
+        fprintf(fic,"%4d",groupState(p_fSt,g));
     }
 
     fprintf(fic,"%5d",p_fSt->groupsWaiting);
 
     for(g=0; g < p_fSt->nGroups; g++) {
-        if(p_fSt->assignedTable[g]!=-1)
-            fprintf(fic,"%4d",p_fSt->assignedTable[g]);
+        if(groupTable(p_fSt,g)!=-1)
+            fprintf(fic,"%4d",groupTable(p_fSt,g));
         else {
             fprintf(fic,"%4s",".");
         }
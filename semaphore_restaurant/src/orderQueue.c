@@ -0,0 +1,117 @@
+/**
+ *  \file orderQueue.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Kitchen order queue.
+ *
+ *  Defined operations:
+ *     \li insertion of an order
+ *     \li removal of the next order to be cooked
+ *     \li name of a kitchen scheduling policy.
+ *
+ *  The queue is a binary heap kept in the shared region. Under FIFO orders leave in arrival
+ *  order; under EDF the order with the earliest deadline leaves first (ties in arrival order).
+ *  The operations must be called within the critical region.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+
+/* internal functions */
+
+/** \brief true if order a must be cooked before order b */
+static bool before (FULL_STAT *p_fSt, ORDER *a, ORDER *b)
+{
+    if ((p_fSt->kitchenPolicy == EDF) && (a->deadline != b->deadline)) {
+        return a->deadline < b->deadline;
+    }
+    return a->seq < b->seq;
+}
+
+static void swap (ORDER *a, ORDER *b)
+{
+    ORDER tmp = *a;
+
+    *a = *b;
+    *b = tmp;
+}
+
+/* external functions */
+
+/**
+ *  \brief Insertion of an order.
+ *
+ *  The queue must not be full.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param group group that placed the order
+ *  \param deadline time stamp (us) by which the food should be ready
+ *  \param payload offset of the order payload in the slab
+ */
+void orderEnqueue (FULL_STAT *p_fSt, int group, long long deadline, uint32_t payload)
+{
+    ORDER *q = p_fSt->orderQueue;
+    int i = p_fSt->orderCount++;
+
+    q[i].group = group;
+    q[i].deadline = deadline;
+    q[i].seq = p_fSt->orderSeq++;
+    q[i].payload = payload;
+    while ((i > 0) && before (p_fSt, &q[i], &q[(i-1)/2])) {
+        swap (&q[i], &q[(i-1)/2]);
+        i = (i - 1) / 2;
+    }
+    if (p_fSt->orderCount > p_fSt->orderQueueMax) {
+        p_fSt->orderQueueMax = p_fSt->orderCount;
+    }
+}
+
+/**
+ *  \brief Removal of the next order to be cooked, according to the kitchen scheduling policy.
+ *
+ *  The queue must not be empty.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *
+ *  \return order removed
+ */
+ORDER orderDequeue (FULL_STAT *p_fSt)
+{
+    ORDER *q = p_fSt->orderQueue;
+    ORDER first = q[0];
+    int i = 0, c;
+
+    q[0] = q[--p_fSt->orderCount];
+    while ((c = 2 * i + 1) < p_fSt->orderCount) {
+        if ((c + 1 < p_fSt->orderCount) && before (p_fSt, &q[c+1], &q[c])) {
+            c++;
+        }
+        if (!before (p_fSt, &q[c], &q[i])) {
+            break;
+        }
+        swap (&q[i], &q[c]);
+        i = c;
+    }
+    return first;
+}
+
+/**
+ *  \brief Name of a kitchen scheduling policy.
+ *
+ *  \param policy policy id
+ *
+ *  \return printable name of the policy
+ */
+const char *kitchenPolicyName (int policy)
+{
+    switch (policy) {
+        case FIFO: return "FIFO";
+        case EDF:  return "EDF";
+    }
+    return "unknown";
+}
@@ -0,0 +1,55 @@
+/**
+ *  \file orderQueue.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Kitchen order queue.
+ *
+ *  Defined operations:
+ *     \li insertion of an order
+ *     \li removal of the next order to be cooked
+ *     \li name of a kitchen scheduling policy.
+ *
+ *  The queue is a binary heap kept in the shared region. Under FIFO orders leave in arrival
+ *  order; under EDF the order with the earliest deadline leaves first (ties in arrival order).
+ *  The operations must be called within the critical region.
+ */
+
+#ifndef ORDERQUEUE_H_
+#define ORDERQUEUE_H_
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Insertion of an order.
+ *
+ *  The queue must not be full.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param group group that placed the order
+ *  \param deadline time stamp (us) by which the food should be ready
+ *  \param payload offset of the order payload in the slab
+ */
+extern void orderEnqueue (FULL_STAT *p_fSt, int group, long long deadline, uint32_t payload);
+
+/**
+ *  \brief Removal of the next order to be cooked, according to the kitchen scheduling policy.
+ *
+ *  The queue must not be empty.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *
+ *  \return order removed
+ */
+extern ORDER orderDequeue (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Name of a kitchen scheduling policy.
+ *
+ *  \param policy policy id
+ *
+ *  \return printable name of the policy
+ */
+extern const char *kitchenPolicyName (int policy);
+
+#endif /* ORDERQUEUE_H_ */
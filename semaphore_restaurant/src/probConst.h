@@ -14,17 +14,74 @@
 /* Generic parameters */
 
 /** \brief maximum number of groups */
+#ifndef MAXGROUPS
 #define  MAXGROUPS       16 
+#endif
 /** \brief number of tables */
+#ifndef NUMTABLES
 #define  NUMTABLES        2  
+#endif
+/** \brief size of a cache line (fields written by different entities never share one) */
+#define  CACHELINE       64
+/** \brief maximum number of seats of a table */
+#define  MAXCAPACITY      8
+/** \brief capacity of the tables not listed in the config file */
+#define  DEFCAPACITY      4
+/** \brief maximum number of orders in the kitchen order queue */
+#define  MAXORDERS       16
+/** \brief maximum number of orders cooked together */
+#define  MAXBATCH        MAXORDERS
+/** \brief number of size classes of the order payload slab (block sizes SLABMIN, 2*SLABMIN, 4*SLABMIN, ...) */
+#define  SLABCLASSES      3
+/** \brief block size (bytes) of the smallest class of the order payload slab */
+#define  SLABMIN         32
+/** \brief blocks of each class of the order payload slab (a group holds at most one payload, and a table) */
+#define  SLABBLOCKS      NUMTABLES
 /** \brief controls time taken to cook */
 #define  MAXCOOK        100 
+/** \brief maximum number of dishes of the menu */
+#define  MAXDISHES       16
+/** \brief mean preparation time (us) of the dish of the default menu */
+#define  DEFDISHMEAN    (100 + MAXCOOK / 2)
+/** \brief standard deviation of the preparation time (us) of the dish of the default menu */
+#define  DEFDISHDEV     (MAXCOOK / 4)
+
+/** \brief maximum number of workers of a kitchen station */
+#define  MAXWORKERS       4
+/** \brief maximum number of portions on the prep-ahead shelf of the kitchen */
+#define  MAXSHELF        32
+/** \brief maximum number of slots of the timer wheel */
+#define  MAXWHEEL      4096
 
 /** \brief controls start time standard deviation */
 #define  STARTDEV         4 
 /** \brief controls eat time standard deviation */
 #define  EATDEV           4 
 
+/* Seat assignment policies */
+/** \brief lowest numbered free table that fits the group */
+#define  FIRSTFIT          0
+/** \brief free table with the smallest capacity that fits the group */
+#define  BESTFIT           1
+/** \brief best-fit, joining free tables when no single table fits the group */
+#define  TABLEJOIN         2
+
+/* Kitchen scheduling policies */
+/** \brief orders are cooked in arrival order */
+#define  FIFO              0
+/** \brief order with the earliest deadline is cooked first */
+#define  EDF               1
+
+/* Kitchen stations (an order goes through all of them, in this order) */
+/** \brief preparation (takes the orders from the kitchen order queue) */
+#define  ST_PREP           0
+/** \brief cooking (batches of orders, timed by the menu) */
+#define  ST_COOK           1
+/** \brief plating (hands the plates to the waiter) */
+#define  ST_PLATE          2
+/** \brief number of stations */
+#define  NSTATIONS         3
+
 /* IDs dos diferentes tipos possíveis de requests */ 
 /** \brief id of table request (group->receptionist) */
 #define TABLEREQ   1
@@ -34,6 +91,8 @@
 #define FOODREQ   3
 /** \brief id of food ready (chef->waiter) */
 #define FOODREADY 4
+/** \brief id of end of service (launcher->waiter and receptionist, continuous mode) */
+#define CLOSEREQ  5
 
 
 /* Client state constants */
@@ -14,8 +14,23 @@
 #define PROBDATASTRUCT_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "probConst.h"
+#include "histogram.h"
+
+#if NUMTABLES > 32
+#error "free table index uses one bit per table (NUMTABLES <= 32)"
+#endif
+#if 8 + 4 * MAXDISHES > SLABMIN << (SLABCLASSES - 1)
+#error "an order with every dish of the menu must fit the largest class of the order payload slab"
+#endif
+#if NUMTABLES > MAXORDERS
+#error "kitchen order queue must hold one order per table (NUMTABLES <= MAXORDERS)"
+#endif
+
+/** \brief starts a field (or every element of a type) on a cache line of its own */
+#define  CACHEALIGNED       __attribute__ ((aligned (CACHELINE)))
 
 /**
  *  \brief Definition of requests to receptionist and waiter 
@@ -25,59 +40,503 @@ typedef struct {
     int reqType;
     /** \brief group that issues the request (dummy/fictício if request source is chef) */
     int reqGroup;
+    /** \brief time stamp (us) by which the food should be ready (food requests only) */
+    long long reqDeadline;
+    /** \brief offset of the order payload in the slab (food requests only, see slab.h) */
+    uint32_t reqPayload;
 } request;
 
+/**
+ *  \brief Definition of an order in the kitchen order queue
+ */
+typedef struct {
+    /** \brief group that placed the order */
+    int group;
+    /** \brief time stamp (us) by which the food should be ready */
+    long long deadline;
+    /** \brief arrival sequence number of the order */
+    unsigned int seq;
+    /** \brief offset of the order payload in the slab (see slab.h) */
+    uint32_t payload;
+} ORDER;
+
+/**
+ *  \brief Definition of an item of an order payload
+ */
+typedef struct {
+    /** \brief dish */
+    uint16_t dish;
+    /** \brief number of portions */
+    uint16_t quantity;
+} ORDERITEM;
+
+/**
+ *  \brief Definition of the content of an order, written by the group in a slab block and read in place
+ */
+typedef struct {
+    /** \brief group that placed the order */
+    int group;
+    /** \brief number of items */
+    int nItems;
+    /** \brief items (as many as fit the block) */
+    ORDERITEM item[];
+} ORDERPAYLOAD;
+
+/** \brief bytes of storage of the order payload slab (SLABBLOCKS blocks of each class) */
+#define  SLABARENA          (SLABBLOCKS * SLABMIN * ((1 << SLABCLASSES) - 1))
+
+/**
+ *  \brief Definition of the order payload slab (lock-free, see slab.h)
+ */
+typedef struct {
+    /** \brief free list of each class: tag in the upper 32 bits, 1 + first free block in the lower (0 if empty) */
+    uint64_t head[SLABCLASSES];
+    /** \brief next free block after each block (1 + block, 0 at the end of the list) */
+    uint32_t next[SLABCLASSES][SLABBLOCKS];
+    /** \brief number of allocations */
+    unsigned int nAlloc;
+    /** \brief number of allocations that found no free block */
+    unsigned int nFailed;
+    /** \brief number of blocks in use */
+    unsigned int inUse;
+    /** \brief largest number of blocks in use during the run */
+    unsigned int peak;
+    /** \brief storage of the blocks, class after class */
+    unsigned char arena[SLABARENA] CACHEALIGNED;
+} SLAB;
+
+/* time stamps of each group (see groupTime); entries GOTOREST .. LEAVING are the entering of each state */
+/** \brief arrival at the restaurant (end of GOTOREST; entry 0 is not a state) */
+#define  T_ARRIVAL          0
+/** \brief sitting down at the table (receptionist) */
+#define  T_SEATED           (LEAVING+1)
+/** \brief food request reaching the kitchen (waiter) */
+#define  T_ORDER            (LEAVING+2)
+/** \brief time by which the food should be ready (waiter) */
+#define  T_DEADLINE         (LEAVING+3)
+/** \brief food ready (chef) */
+#define  T_READY            (LEAVING+4)
+/** \brief number of time stamps of each group */
+#define  NTIMES             (LEAVING+5)
+
+/* phases of the lifecycle of a group (see lifecycle.h) */
+/** \brief arrival -> at reception (waiting for the receptionist to be free) */
+#define  PH_RECEPTION       0
+/** \brief at reception -> food request (waiting for a table) */
+#define  PH_TABLE           1
+/** \brief food request -> waiting for food (waiting for the waiter to take the order) */
+#define  PH_ORDER           2
+/** \brief order queued -> food ready (waiting in the kitchen queue and cooking) */
+#define  PH_KITCHEN         3
+/** \brief food ready -> eating (waiting for the waiter to bring the food) */
+#define  PH_DELIVERY        4
+/** \brief checkout -> leaving (paying the bill) */
+#define  PH_CHECKOUT        5
+/** \brief arrival -> leaving */
+#define  PH_TOTAL           6
+
+/** \brief number of phases */
+#define  NPHASES            7
+
+/**
+ *  \brief Definition of the time stamps of a group
+ *
+ *  The stamps are taken relative to the start of the present visit of the group, so that a visit, not the whole
+ *  service, must fit the range of the encoding (about 71 minutes). The arrival stamp is taken by the group itself
+ *  without the mutex, so every group has a cache line of its own.
+ */
+typedef struct CACHEALIGNED {
+    /** \brief time stamp (us) the stamps of the present visit are relative to */
+    long long base;
+    /** \brief time stamps T_ARRIVAL .. T_READY (us since base plus one, 0 if never taken, see groupTime) */
+    uint32_t t[NTIMES];
+} GROUPTIMES;
+
+/**
+ *  \brief Definition of a station of the kitchen pipeline
+ *
+ *  The workers of a station take orders from its queue (the kitchen order queue, for the first station) and pass
+ *  them on to the queue of the next one, blocking while it is full. Each station is written by its own workers.
+ */
+typedef struct CACHEALIGNED {
+    /** \brief number of workers */
+    int workers;
+    /** \brief process identifiers of the workers (0 if not running; stored by the chef, see soak.h) */
+    int pid[MAXWORKERS];
+    /** \brief capacity of the queue (that of the kitchen order queue, for the first station) */
+    int capacity;
+    /** \brief working time (us) per portion (the cook station follows the menu instead) */
+    int perPortion;
+    /** \brief queue of orders waiting for a worker, in kitchen policy order (not used by the first station) */
+    ORDER queue[MAXORDERS];
+    /** \brief position of the first order of the queue */
+    int head;
+    /** \brief number of orders in the queue */
+    int count;
+    /** \brief number of orders taken by the workers */
+    int taken;
+    /** \brief largest number of orders in the queue during the run */
+    int maxCount;
+    /** \brief time stamp (us) of the last change of the number of orders in the queue */
+    long long lastChange;
+    /** \brief integral of the number of orders in the queue over time (orders x us) */
+    long long depthUsage;
+    /** \brief time (us) spent by the workers working */
+    long long busy;
+    /** \brief time (us) spent by the workers blocked on the full queue of the next station */
+    long long blocked;
+} STATION;
+
+/**
+ *  \brief Definition of the prep-ahead shelf of the kitchen
+ *
+ *  Idle cooks pre-cook the dishes that have been most popular so far and keep the portions on the shelf until an
+ *  order asks for them or they spoil. Written by the workers of the cook station.
+ */
+typedef struct CACHEALIGNED {
+    /** \brief largest number of portions on the shelf (0 - no pre-cooking) */
+    int capacity;
+    /** \brief time (us) after which a portion on the shelf spoils */
+    int spoil;
+    /** \brief time (us) a cook waits for an order before pre-cooking */
+    int idle;
+    /** \brief dish of each portion on the shelf, oldest first */
+    int dish[MAXSHELF];
+    /** \brief time stamp (us) at which each portion on the shelf was cooked */
+    long long cooked[MAXSHELF];
+    /** \brief number of portions on the shelf */
+    int count;
+    /** \brief number of portions of each dish being pre-cooked */
+    int pending[MAXDISHES];
+    /** \brief number of portions of each dish asked for by the orders so far (the popularity model) */
+    int demand[MAXDISHES];
+    /** \brief number of portions asked for by the orders so far */
+    int nDemand;
+    /** \brief number of portions pre-cooked */
+    int nCooked;
+    /** \brief number of portions served from the shelf */
+    int nHits;
+    /** \brief number of orders served entirely from the shelf */
+    int nOrderHits;
+    /** \brief number of portions thrown away because they spoiled */
+    int nSpoiled;
+    /** \brief time (us) spent pre-cooking */
+    long long busy;
+    /** \brief cooking time (us) avoided by serving portions from the shelf */
+    long long saved;
+} SHELF;
+
+/* slots of the resource usage table */
+/** \brief chef */
+#define  U_CHEF             0
+/** \brief waiter */
+#define  U_WAITER           1
+/** \brief receptionist */
+#define  U_RECEPTIONIST     2
+/** \brief first group agent (agent k uses U_GROUP+k) */
+#define  U_GROUP            3
+/** \brief number of slots */
+#define  NUSAGE             (U_GROUP+MAXGROUPS)
+
+/**
+ *  \brief Definition of the resource usage of the process of an intervening entity
+ *
+ *  Each entity stores its own record without the mutex, so every record has a cache line of its own.
+ */
+typedef struct CACHEALIGNED {
+    /** \brief process identifier (0 if the process was not waited for) */
+    int pid;
+    /** \brief user CPU time (us) */
+    long long utime;
+    /** \brief system CPU time (us) */
+    long long stime;
+    /** \brief voluntary context switches (blocking) */
+    long nvcsw;
+    /** \brief involuntary context switches (preemption) */
+    long nivcsw;
+    /** \brief semaphore operations (stored by the entity itself before terminating) */
+    long long semOps;
+} USAGE;
 
 /**
  *  \brief Definition of <em>state of the intervening entities</em> data type. -> Estado de todas as entidades que participam
+ *
+ *  Each entity changes its own state, so the states of the receptionist, the waiter and the chef and the array of
+ *  the group states sit on separate cache lines.
  */
 typedef struct {
     /** \brief receptionist state */
-    unsigned int receptionistStat;
+    unsigned int receptionistStat CACHEALIGNED;
     /** \brief waiter state */
-    unsigned int waiterStat;
+    unsigned int waiterStat CACHEALIGNED;
     /** \brief chef state */
-    unsigned int chefStat;
-    /** \brief group state array */
-    unsigned int groupStat[MAXGROUPS];
+    unsigned int chefStat CACHEALIGNED;
+    /** \brief group state array (one byte per group, see groupState) */
+    uint8_t groupStat[MAXGROUPS] CACHEALIGNED;
 
 } STAT;
 
 
 /**
  *  \brief Definition of <em>full state of the problem</em> data type. 
+ *
+ *  The fields are grouped by the entity that writes them, each group starting on a cache line of its own:
+ *  configuration of the run (read-only once the simulation starts), seating (receptionist), kitchen (waiter and
+ *  chef), delivery (chef and waiter), the request slots and the records each process writes without the mutex.
  */
 typedef struct
 {   /** \brief state of all intervening entities */
     STAT st;
 
+    /* configuration of the run (launcher) */
     /** \brief number of groups */
-    int nGroups;
-    /** \brief number of groups waiting for table */
-    int groupsWaiting;
-
+    int nGroups CACHEALIGNED;
+    /** \brief seed of the random generators (0 - random); each entity seeds its own with seed plus its usage slot */
+    unsigned int seed;
     /** \brief estimated start time of groups */
     int startTime[MAXGROUPS];
     /** \brief estimated eat time of groups */
     int eatTime[MAXGROUPS];
+    /** \brief number of people of each group */
+    uint8_t groupSize[MAXGROUPS];
+    /** \brief number of seats of each table */
+    int tableCapacity[NUMTABLES];
+    /** \brief seat assignment policy (FIRSTFIT, BESTFIT or TABLEJOIN) */
+    int seatPolicy;
+    /** \brief number of groups that fit the restaurant and will be served (visits served, in the continuous mode) */
+    int nServed;
+    /** \brief kitchen scheduling policy (FIFO or EDF) */
+    int kitchenPolicy;
+    /** \brief service target (us): food should be ready this long after the group sat down */
+    int serviceTarget;
+    /** \brief capacity of the kitchen order queue */
+    int orderQueueSize;
+    /** \brief largest number of orders cooked together */
+    int maxBatch;
+    /** \brief time (us) the chef waits for more orders after taking the first one of a batch */
+    int batchWindow;
+    /** \brief additional cooking time (us) of each order of a batch besides the first */
+    int cookPerDish;
+    /** \brief largest number of plates the waiter carries per trip */
+    int maxPlates;
+    /** \brief time (us) the waiter takes on each trip to the tables */
+    int tripTime;
+    /** \brief number of dishes of the menu */
+    int nDishes;
+    /** \brief mean preparation time (us) of each dish */
+    int dishMean[MAXDISHES];
+    /** \brief standard deviation of the preparation time (us) of each dish */
+    int dishDev[MAXDISHES];
+    /** \brief continuous mode: groups come back after leaving until the end of service */
+    bool continuous;
+    /** \brief length (ms) of the service in the continuous mode (0 - until SIGINT or SIGTERM) */
+    int duration;
+    /** \brief length (ms) of the measurement windows in the continuous mode */
+    int window;
+    /** \brief number of group agents: processes that live the visits of the groups, one visit at a time */
+    int nAgents;
+    /** \brief tick (us) of the timer wheel that wakes the group agents (0 - each agent sleeps by itself) */
+    int timerTick;
+    /** \brief number of slots of the timer wheel */
+    int timerSlots;
+    /** \brief time stamp (us) of the start of operations */
+    long long runStart;
 
-    /** \brief saves the table that is being used by each group */
-    int assignedTable[MAXGROUPS];
+    /* seating (receptionist) */
+    /** \brief number of groups waiting for table */
+    int groupsWaiting CACHEALIGNED;
+    /** \brief number of groups turned away at reception */
+    int nRejected;
+    /** \brief saves the table that is being used by each group (-1 if none, see groupTable) */
+    int16_t assignedTable[MAXGROUPS];
+    /** \brief group seated at each table (-1 if free); joined tables point to the same group */
+    int tableGroup[NUMTABLES];
+    /** \brief free tables indexed by capacity (bit t of entry c is set if table t is free and has c seats) */
+    unsigned int freeTables[MAXCAPACITY+1];
+    /** \brief time stamp (us) of the last change of the seated people */
+    long long lastSeatChange;
+    /** \brief number of people presently seated */
+    int seatedPeople;
+    /** \brief number of seats of the tables presently occupied */
+    int occupiedSeats;
+    /** \brief integral of the seated people over time (people x us) */
+    long long seatUsage;
+    /** \brief integral of the seats of occupied tables over time (seats x us) */
+    long long occupiedUsage;
 
-    /** \brief flag of food request from waiter to chef */
-    int foodOrder;
-    /** \brief group associated to food request from waiter to chef */
-    int foodGroup;
+    /* kitchen (waiter queues the orders, chef takes them) */
+    /** \brief kitchen order queue: orders taken to the chef (binary heap, see orderQueue.h) */
+    ORDER orderQueue[MAXORDERS] CACHEALIGNED;
+    /** \brief arrival sequence number of the next order */
+    unsigned int orderSeq;
+    /** \brief number of orders in the kitchen order queue */
+    int orderCount;
+    /** \brief largest number of orders in the kitchen order queue during the run */
+    int orderQueueMax;
 
+    /* kitchen pipeline (each station written by its workers) */
+    /** \brief stations, indexed by ST_PREP .. ST_PLATE */
+    STATION station[NSTATIONS];
+    /** \brief prep-ahead shelf (written by the cook workers) */
+    SHELF shelf;
 
-    /** \brief used by groups to store request to receptionist */
-    request receptionistRequest;
+    /* delivery (chef cooks the plates, waiter takes them to the tables) */
+    /** \brief number of batches cooked */
+    int nBatches CACHEALIGNED;
+    /** \brief number of portions cooked (read from the order payloads) */
+    int nPortions;
+    /** \brief number of portions cooked of each dish */
+    int dishPortions[MAXDISHES];
+    /** \brief time (us) spent by the chef cooking */
+    long long chefBusy;
+    /** \brief plates ready to be taken to the tables (orders, in the order they were cooked) */
+    ORDER readyPlates[MAXORDERS];
+    /** \brief number of plates ready to be taken to the tables */
+    int readyCount;
+    /** \brief flag of food ready request from chef to waiter not yet served */
+    bool readyPending;
+    /** \brief number of food ready requests issued (keys of the trace flows) */
+    int readySeq;
+    /** \brief number of trips of the waiter to the tables */
+    int nTrips CACHEALIGNED;
+    /** \brief number of trips of the waiter carrying each number of plates */
+    int tripPlates[MAXORDERS+1];
+    /** \brief time (us) spent by the waiter serving requests */
+    long long waiterBusy;
+    /** \brief time (us) spent by the waiter blocked on a full kitchen order queue */
+    long long waiterStall;
+
+    /* continuous service (groups, launcher) */
+    /** \brief no group starts a new visit (set from the start, unless in the continuous mode) */
+    bool closing CACHEALIGNED;
+    /** \brief number of visits of the groups to the restaurant */
+    int nVisits;
+    /** \brief number of visits that ended with the group leaving after paying */
+    int nLeft;
+    /** \brief time (us) from arrival to the food being served of the visits of the current window */
+    HISTOGRAM serveWindow;
+
+    /* measurements of every visit, taken as it ends (groups, within the critical region, see visitRecord) */
+    /** \brief latency (us) of each phase of the lifecycle of the visits */
+    HISTOGRAM visitPhase[NPHASES] CACHEALIGNED;
+    /** \brief tardiness (us) of the food of the visits that ordered (0 if ready by the deadline) */
+    HISTOGRAM visitTardiness;
+    /** \brief number of visits whose food was ready after the deadline */
+    int visitMissed;
+
+    /* arrival queue (group agents, launcher) */
+    /** \brief groups due at the restaurant, in the order the agents take them (ring of nGroups entries, see arrival.h) */
+    int arrival[MAXGROUPS] CACHEALIGNED;
+    /** \brief time stamp (us) from which the trip to the restaurant of each queued group is counted */
+    long long arrivalSince[MAXGROUPS];
+    /** \brief position of the first queued group */
+    int arrivalHead;
+    /** \brief number of queued groups */
+    int arrivalCount;
+    /** \brief agent living the present visit of each group (-1 before the first, see groupAgent) */
+    int visitAgent[MAXGROUPS];
+
+    /* timer wheel (group agents post timers without the mutex, the timer thread of the launcher fires them) */
+    /** \brief timers posted and not yet taken by the timer thread (agent id plus one, 0 if free; see timer.h) */
+    int timerRing[MAXGROUPS] CACHEALIGNED;
+    /** \brief number of timers ever posted (the next one goes to entry timerTail % MAXGROUPS) */
+    unsigned long long timerTail;
+    /** \brief time stamp (us) at which the timer of each agent expires */
+    long long timerDue[MAXGROUPS];
+    /** \brief number of timers fired (timer thread) */
+    long long timerFired CACHEALIGNED;
+    /** \brief number of ticks of the timer wheel processed (timer thread) */
+    long long timerTicks;
+    /** \brief number of timers looked at by the ticks, fired or not (timer thread) */
+    long long timerVisits;
+    /** \brief time (us) from the expiry of a sleep of a group to its agent being awake (groups, critical region) */
+    HISTOGRAM wakeJitter CACHEALIGNED;
 
+    /* request slots */
+    /** \brief used by groups to store request to receptionist */
+    request receptionistRequest CACHEALIGNED;
     /** \brief used by groups and chef to store request to waiter */
-    request waiterRequest; 
+    request waiterRequest CACHEALIGNED; 
+
+    /* order payloads (allocated by the groups, read in place by waiter and chef, freed on delivery; lock-free) */
+    /** \brief order payload slab */
+    SLAB slab CACHEALIGNED;
 
+    /* per-group time stamps (one cache line each); the arrival stamp is written by the group itself without the
+       mutex, the others within the critical region */
+    /** \brief time stamps of each group */
+    GROUPTIMES groupTimes[MAXGROUPS];
+
+    /* records written by each process without the mutex (one cache line each) */
+    /** \brief resource usage of the process of each entity, indexed by slot (U_CHEF .. U_GROUP+k) */
+    USAGE usage[NUSAGE];
 
 } FULL_STAT;
 
+/*
+ *  Accessors of the per-group data.
+ *  The states and tables are stored as arrays of narrow types (one byte per state, two per table), so that passes
+ *  over all the groups (snapshots, logging, the report) touch a few cache lines. The time stamps take four bytes
+ *  each, in a cache line per group, so that a group stamping its arrival does not disturb the others. They are
+ *  kept relative to the start of the visit, which limits a visit, not a run, to about 71 minutes.
+ */
+
+/** \brief state of group g */
+static inline unsigned int groupState (const FULL_STAT *p_fSt, int g)
+{
+    return p_fSt->st.groupStat[g];
+}
+
+/** \brief changing the state of group g */
+static inline void setGroupState (FULL_STAT *p_fSt, int g, unsigned int state)
+{
+    p_fSt->st.groupStat[g] = (uint8_t) state;
+}
+
+/** \brief table assigned to group g (-1 if none) */
+static inline int groupTable (const FULL_STAT *p_fSt, int g)
+{
+    return p_fSt->assignedTable[g];
+}
+
+/** \brief assigning table t to group g (-1 if none) */
+static inline void setGroupTable (FULL_STAT *p_fSt, int g, int t)
+{
+    p_fSt->assignedTable[g] = (int16_t) t;
+}
+
+/** \brief agent living the present visit of group g (-1 before the first) */
+static inline int groupAgent (const FULL_STAT *p_fSt, int g)
+{
+    return p_fSt->visitAgent[g];
+}
+
+/** \brief time stamp k (T_ARRIVAL .. T_READY) of group g (us, 0 if never taken) */
+static inline long long groupTime (const FULL_STAT *p_fSt, int g, int k)
+{
+    uint32_t v = p_fSt->groupTimes[g].t[k];
+
+    return (v != 0) ? p_fSt->groupTimes[g].base + v - 1 : 0;
+}
+
+/** \brief forgetting all time stamps of group g (a new visit starts at time stamp base, us) */
+static inline void clearGroupTimes (FULL_STAT *p_fSt, int g, long long base)
+{
+    int k;
+
+    p_fSt->groupTimes[g].base = base;
+    for (k = 0; k < NTIMES; k++) {
+        p_fSt->groupTimes[g].t[k] = 0;
+    }
+}
+
+/** \brief taking time stamp k (T_ARRIVAL .. T_READY) of group g (saturates past the range of the encoding) */
+static inline void setGroupTime (FULL_STAT *p_fSt, int g, int k, long long t)
+{
+    long long v = t - p_fSt->groupTimes[g].base + 1;
+
+    p_fSt->groupTimes[g].t[k] = (v < 1) ? 1 : (v > UINT32_MAX) ? UINT32_MAX : (uint32_t) v;
+}
+
 
 #endif /* PROBDATASTRUCT_H_ */
@@ -8,7 +8,13 @@
  *
  *  Generator process of the intervening entities.
  *
- *  Upon execution, one parameter is requested:
+ *  Upon execution, the following parameters are accepted:
+ *    \li <tt>-c</tt> name of the config file (config.txt by default)
+ *    \li <tt>-r</tt> name of the file where a machine-readable record of the run is saved
+ *    \li <tt>-m</tt> shared memory backend and options, e.g. <tt>posix,populate,lock</tt> (see sharedMemory.h)
+ *    \li <tt>-t</tt> name of the file where an execution trace (Trace Event Format) is saved
+ *    \li <tt>-s</tt> seed of the random generators of the entities (random per run by default), so that
+ *        runs with the same seed draw the same cooking and eating times
  *    \li name of the logging file.
  *
  *  \author Nuno Lau - December 2023
@@ -18,10 +24,13 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <signal.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <string.h>
+#include <errno.h>
 #include <math.h>
 
 #include "probConst.h"
@@ -30,6 +39,16 @@
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "seating.h"
+#include "slab.h"
+#include "kitchen.h"
+#include "shelf.h"
+#include "timing.h"
+#include "report.h"
+#include "soak.h"
+#include "arrival.h"
+#include "timer.h"
+#include "trace.h"
 
 /** \brief name of chef process */
 #define   CHEF               "./chef"
@@ -42,6 +61,248 @@
 
 /** \brief name of chef process */
 #define   RECEPTIONIST       "./receptionist"
+
+/** \brief maximum length of a line of the config file */
+#define   LINELEN            256
+
+/** \brief name of the config file */
+static char *cfgName = "config.txt";
+
+/**
+ *  \brief reads next non empty line of the config file.
+ *
+ *  \return pointer to the line read or NULL at end of file
+ */
+static char *readLine (FILE *fp, char line[])
+{
+    while (fgets (line, LINELEN, fp) != NULL) {
+        if (strspn (line, " \t\r\n") != strlen (line)) {
+            return line;
+        }
+    }
+    return NULL;
+}
+
+/**
+ *  \brief aborts on a malformed config file.
+ */
+static void configError (char *msg)
+{
+    fprintf (stderr, "%s: %s\n", cfgName, msg);
+    exit (EXIT_FAILURE);
+}
+
+/**
+ *  \brief parses the config file.
+ *
+ *  The file starts with the number of groups (1 .. MAXGROUPS, fixed at compile time) followed by one line per
+ *  group (start time, eat time and, optionally, the number of people of the group).
+ *  Optional settings follow, each one as a comment line naming it and a line with its value:
+ *    \li <tt>#tableCapacity</tt> number of seats of each table
+ *    \li <tt>#seatPolicy</tt> seat assignment policy (0 - first-fit, 1 - best-fit, 2 - table joining)
+ *    \li <tt>#orderQueue</tt> capacity of the kitchen order queue (NUMTABLES .. MAXORDERS)
+ *    \li <tt>#batch</tt> largest batch of orders cooked together (1 .. MAXBATCH), time the chef waits for
+ *        more orders after the first one (us) and additional cooking time of each order of a batch besides the first (us)
+ *    \li <tt>#kitchenPolicy</tt> kitchen scheduling policy (0 - FIFO, 1 - EDF) and service target (us),
+ *        i.e. how long after sitting down the food of a group should be ready
+ *    \li <tt>#delivery</tt> largest number of plates the waiter carries per trip (1 .. MAXORDERS) and time
+ *        of each trip (us)
+ *    \li <tt>#menu</tt> mean and standard deviation (us) of the preparation time of each dish (1 .. MAXDISHES dishes)
+ *    \li <tt>#stations</tt> number of workers at the prep, cook and plate stations (1 .. MAXWORKERS each)
+ *    \li <tt>#stationQueue</tt> capacity of the queues of the cook and plate stations (1 .. MAXORDERS); the queue
+ *        of the prep station is the kitchen order queue
+ *    \li <tt>#stationTime</tt> time per portion (us) at the prep and plate stations
+ *    \li <tt>#shelf</tt> capacity of the prep-ahead shelf in portions (0 .. MAXSHELF, 0 - no pre-cooking), time
+ *        after which a pre-cooked portion spoils (us) and time a cook waits for an order before pre-cooking (us)
+ *    \li <tt>#continuous</tt> continuous mode (see soak.h): length of the service (ms, 0 - until SIGINT or SIGTERM)
+ *        and length of the measurement windows (ms)
+ *    \li <tt>#agents</tt> number of group agents (1 .. number of groups, see arrival.h); by default there is one
+ *        agent per group (the agents bound the group processes, not the number of groups)
+ *    \li <tt>#timer</tt> tick (us, 0 - each group agent sleeps by itself) and number of slots (1 .. MAXWHEEL) of the
+ *        timer wheel that wakes the group agents (see timer.h).
+ */
+static void parseConfig (FILE *fp, FULL_STAT *p_fSt)
+{
+    char line[LINELEN], key[LINELEN];
+    char *tok;
+    int g, t, n, size;
+
+    /* defaults */
+    for (t = 0; t < NUMTABLES; t++) {
+        p_fSt->tableCapacity[t] = DEFCAPACITY;
+    }
+    p_fSt->seatPolicy = FIRSTFIT;
+    p_fSt->orderQueueSize = MAXORDERS;
+    p_fSt->kitchenPolicy = FIFO;
+    p_fSt->serviceTarget = 2000;
+    p_fSt->maxBatch = 1;
+    p_fSt->maxPlates = 1;
+    p_fSt->tripTime = 0;
+    p_fSt->batchWindow = 0;
+    p_fSt->cookPerDish = 0;
+    for (t = 0; t < NSTATIONS; t++) {
+        p_fSt->station[t].workers = 1;
+        p_fSt->station[t].capacity = MAXORDERS;
+        p_fSt->station[t].perPortion = 0;
+    }
+    p_fSt->continuous = false;
+    p_fSt->duration = 0;
+    p_fSt->window = 1000;
+    p_fSt->timerTick = 0;
+    p_fSt->timerSlots = 256;
+    p_fSt->shelf.capacity = 0;
+    p_fSt->shelf.spoil = 5000;
+    p_fSt->shelf.idle = 200;
+    p_fSt->nDishes = 1;
+    p_fSt->dishMean[0] = DEFDISHMEAN;
+    p_fSt->dishDev[0] = DEFDISHDEV;
+
+    if ((readLine (fp, line) == NULL) || (readLine (fp, line) == NULL) ||
+        (sscanf (line, "%d", &p_fSt->nGroups) != 1)) {
+        configError ("number of groups is missing");
+    }
+    if ((p_fSt->nGroups < 1) || (p_fSt->nGroups > MAXGROUPS)) {
+        configError ("number of groups is out of range");
+    }
+    if (readLine (fp, line) == NULL) {
+        configError ("group descriptions are missing");
+    }
+    for (g = 0; g < p_fSt->nGroups; g++) {
+        if (readLine (fp, line) == NULL) {
+            configError ("group descriptions are missing");
+        }
+        n = sscanf (line, "%d %d %d", &p_fSt->startTime[g], &p_fSt->eatTime[g], &size);
+        if (n < 2) {
+            configError ("group description is malformed");
+        }
+        if (n == 2) {
+            size = 1;
+        }
+        if ((size < 1) || (size > UINT8_MAX)) {
+            configError ("group size is out of range");
+        }
+        p_fSt->groupSize[g] = (uint8_t) size;
+    }
+    p_fSt->nAgents = p_fSt->nGroups;
+
+    while (readLine (fp, line) != NULL) {
+        if ((line[0] != '#') || (sscanf (line + 1, "%s", key) != 1) || (readLine (fp, line) == NULL)) {
+            configError ("setting is malformed");
+        }
+        if (strcmp (key, "tableCapacity") == 0) {
+            for (t = 0, tok = strtok (line, " \t\r\n"); (t < NUMTABLES) && (tok != NULL);
+                 t++, tok = strtok (NULL, " \t\r\n")) {
+                p_fSt->tableCapacity[t] = atoi (tok);
+                if ((p_fSt->tableCapacity[t] < 1) || (p_fSt->tableCapacity[t] > MAXCAPACITY)) {
+                    configError ("table capacity is out of range");
+                }
+            }
+        }
+        else if (strcmp (key, "seatPolicy") == 0) {
+            if ((sscanf (line, "%d", &p_fSt->seatPolicy) != 1) ||
+                (p_fSt->seatPolicy < FIRSTFIT) || (p_fSt->seatPolicy > TABLEJOIN)) {
+                configError ("seat policy is out of range");
+            }
+        }
+        else if (strcmp (key, "orderQueue") == 0) {
+            /* each seated group has at most one order in the kitchen, so a smaller queue could block the waiter for good */
+            if ((sscanf (line, "%d", &p_fSt->orderQueueSize) != 1) ||
+                (p_fSt->orderQueueSize < NUMTABLES) || (p_fSt->orderQueueSize > MAXORDERS)) {
+                configError ("order queue capacity is out of range");
+            }
+        }
+        else if (strcmp (key, "kitchenPolicy") == 0) {
+            if ((sscanf (line, "%d %d", &p_fSt->kitchenPolicy, &p_fSt->serviceTarget) != 2) ||
+                (p_fSt->kitchenPolicy < FIFO) || (p_fSt->kitchenPolicy > EDF) || (p_fSt->serviceTarget < 0)) {
+                configError ("kitchen policy setting is out of range");
+            }
+        }
+        else if (strcmp (key, "batch") == 0) {
+            if ((sscanf (line, "%d %d %d", &p_fSt->maxBatch, &p_fSt->batchWindow, &p_fSt->cookPerDish) != 3) ||
+                (p_fSt->maxBatch < 1) || (p_fSt->maxBatch > MAXBATCH) ||
+                (p_fSt->batchWindow < 0) || (p_fSt->cookPerDish < 0)) {
+                configError ("batch setting is out of range");
+            }
+        }
+        else if (strcmp (key, "menu") == 0) {
+            for (p_fSt->nDishes = 0, tok = strtok (line, " \t\r\n"); tok != NULL; tok = strtok (NULL, " \t\r\n")) {
+                if (p_fSt->nDishes == MAXDISHES) {
+                    configError ("menu has too many dishes");
+                }
+                p_fSt->dishMean[p_fSt->nDishes] = atoi (tok);
+                if ((tok = strtok (NULL, " \t\r\n")) == NULL) {
+                    configError ("menu dish is malformed");
+                }
+                p_fSt->dishDev[p_fSt->nDishes] = atoi (tok);
+                if ((p_fSt->dishMean[p_fSt->nDishes] < 0) || (p_fSt->dishDev[p_fSt->nDishes] < 0)) {
+                    configError ("menu dish is out of range");
+                }
+                p_fSt->nDishes++;
+            }
+            if (p_fSt->nDishes == 0) {
+                configError ("menu is empty");
+            }
+        }
+        else if (strcmp (key, "stations") == 0) {
+            if ((sscanf (line, "%d %d %d", &p_fSt->station[ST_PREP].workers, &p_fSt->station[ST_COOK].workers,
+                         &p_fSt->station[ST_PLATE].workers) != 3)) {
+                configError ("stations setting is malformed");
+            }
+            for (t = 0; t < NSTATIONS; t++) {
+                if ((p_fSt->station[t].workers < 1) || (p_fSt->station[t].workers > MAXWORKERS)) {
+                    configError ("number of workers of a station is out of range");
+                }
+            }
+        }
+        else if (strcmp (key, "stationQueue") == 0) {
+            if ((sscanf (line, "%d %d", &p_fSt->station[ST_COOK].capacity, &p_fSt->station[ST_PLATE].capacity) != 2) ||
+                (p_fSt->station[ST_COOK].capacity < 1) || (p_fSt->station[ST_COOK].capacity > MAXORDERS) ||
+                (p_fSt->station[ST_PLATE].capacity < 1) || (p_fSt->station[ST_PLATE].capacity > MAXORDERS)) {
+                configError ("station queue capacity is out of range");
+            }
+        }
+        else if (strcmp (key, "stationTime") == 0) {
+            if ((sscanf (line, "%d %d", &p_fSt->station[ST_PREP].perPortion, &p_fSt->station[ST_PLATE].perPortion) != 2) ||
+                (p_fSt->station[ST_PREP].perPortion < 0) || (p_fSt->station[ST_PLATE].perPortion < 0)) {
+                configError ("station time is out of range");
+            }
+        }
+        else if (strcmp (key, "shelf") == 0) {
+            if ((sscanf (line, "%d %d %d", &p_fSt->shelf.capacity, &p_fSt->shelf.spoil, &p_fSt->shelf.idle) != 3) ||
+                (p_fSt->shelf.capacity < 0) || (p_fSt->shelf.capacity > MAXSHELF) ||
+                (p_fSt->shelf.spoil < 1) || (p_fSt->shelf.idle < 1)) {
+                configError ("shelf setting is out of range");
+            }
+        }
+        else if (strcmp (key, "continuous") == 0) {
+            if ((sscanf (line, "%d %d", &p_fSt->duration, &p_fSt->window) != 2) ||
+                (p_fSt->duration < 0) || (p_fSt->window < 1)) {
+                configError ("continuous setting is out of range");
+            }
+            p_fSt->continuous = true;
+        }
+        else if (strcmp (key, "agents") == 0) {
+            if ((sscanf (line, "%d", &p_fSt->nAgents) != 1) ||
+                (p_fSt->nAgents < 1) || (p_fSt->nAgents > p_fSt->nGroups)) {
+                configError ("number of group agents is out of range");
+            }
+        }
+        else if (strcmp (key, "timer") == 0) {
+            if ((sscanf (line, "%d %d", &p_fSt->timerTick, &p_fSt->timerSlots) != 2) ||
+                (p_fSt->timerTick < 0) || (p_fSt->timerSlots < 1) || (p_fSt->timerSlots > MAXWHEEL)) {
+                configError ("timer setting is out of range");
+            }
+        }
+        else if (strcmp (key, "delivery") == 0) {
+            if ((sscanf (line, "%d %d", &p_fSt->maxPlates, &p_fSt->tripTime) != 2) ||
+                (p_fSt->maxPlates < 1) || (p_fSt->maxPlates > MAXORDERS) || (p_fSt->tripTime < 0)) {
+                configError ("delivery setting is out of range");
+            }
+        }
+        else configError ("setting is unknown");
+    }
+}
+
 /**
  *  \brief Main program.
  *
@@ -51,24 +312,50 @@
 int main (int argc, char *argv[])
 {
     char nFic[51];                                                                              /*name of logging file */
+    char *nRec = NULL;                                                         /* name of the record file of the run */
+    unsigned int seed = 0;                                          /* seed of the random generators (0 - random) */
     char nFicErr[] = "error_        ";                                                     /* base name of error files */
     int shmid,                                                                      /* shared memory access identifier */
         semgid;                                                                     /* semaphore set access identifier */
     unsigned int  m;                                                                             /* counting variables */
     SHARED_DATA *sh;   // -> SHARED_DATA em sharedDataSync.h                        /* pointer to shared memory region */
+    pid_t staff[3];                                              /* staff processes identifiers (continuous mode) */
+    int nGone = 0;                                                /* number of group agent processes terminated */
     int pidCH,                                                                             /* pilot process identifier */
         pidWT,                                                                     /* hostess process identifier array */
         pidRT,                                                                     /* hostess process identifier array */
-        pidGR[MAXGROUPS];                                                     /* passengers processes identifier array */
+        pidGR[MAXGROUPS];                                                    /* group agents processes identifier array */
     int key;                                                           /*access key to shared memory and semaphore set */
     char num[2][12];                                                     /* numeric value conversion (up to 10 digits) */
     int status,                                                                                    /* execution status */
         info;                                                                                               /* info id */
-    int g, t;
+    struct rusage ru;                                                     /* resource usage of a terminated process */
+    USAGE *u;                                                           /* usage slot of a terminated process */
+    int g, t, opt;
+    long long runEnd;                                                                  /* time stamp of the end of run */
 
-    /* getting log file name */
-    if(argc==2) {
-        strcpy(nFic, argv[1]);
+    /* getting options and log file name */
+    while ((opt = getopt (argc, argv, "c:m:r:s:t:")) != -1) {
+        switch (opt) {
+            case 'c': cfgName = optarg;
+                      break;
+            case 'm': if (setenv (SHMEMENV, optarg, 1) == -1) {       /* entities generated from now on inherit it */
+                          perror ("error on selecting the shared memory backend");
+                          exit (EXIT_FAILURE);
+                      }
+                      break;
+            case 'r': nRec = optarg;
+                      break;
+            case 's': seed = (unsigned int) strtoul (optarg, NULL, 10);
+                      break;
+            case 't': traceCreate (optarg);                       /* entities generated from now on trace */
+                      break;
+            default:  fprintf (stderr, "Usage: %s [-c config] [-m shared memory] [-r record] [-s seed] [-t trace] [logfile]\n", argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if (optind < argc) {
+        snprintf (nFic, sizeof (nFic), "%s", argv[optind]);
     }
     else strcpy(nFic, "");
 
@@ -90,32 +377,70 @@ int main (int argc, char *argv[])
     }
 
     /* initialize random generator */
-    srandom ((unsigned int) getpid ());                                
+    sh->fSt.seed = seed;
+    srandom ((seed != 0) ? seed : (unsigned int) getpid ());
 
     /* initialize problem internal status */
     sh->fSt.st.chefStat         = WAIT_FOR_ORDER;                     /* the chef waits for an order */
     sh->fSt.st.waiterStat       = WAIT_FOR_REQUEST;                /* the waiter waits for a request */
     sh->fSt.st.receptionistStat = WAIT_FOR_REQUEST;          /* the receptionist waits for a request */
     for (g = 0; g < MAXGROUPS; g++) {
-        sh->fSt.st.groupStat[g] = GOTOREST;                                /* groups are initialized */
-        sh->fSt.assignedTable[g] = -1;                                     /* groups are initialized */
+        setGroupState (&sh->fSt, g, GOTOREST);                             /* groups are initialized */
+        setGroupTable (&sh->fSt, g, -1);                                   /* groups are initialized */
     }
+    memset (sh->fSt.groupTimes, 0, sizeof (sh->fSt.groupTimes));                  /* no time stamps taken yet */
+    slabInit (&sh->fSt.slab);                                                   /* all order payload blocks free */
     sh->fSt.groupsWaiting=0;
+    memset (sh->fSt.usage, 0, sizeof (sh->fSt.usage));                    /* no process waited for yet */
+    sh->seq = 0;                                                     /* no update of the shared data in progress */
+    sh->fSt.orderSeq = sh->fSt.orderCount = sh->fSt.orderQueueMax = 0;
+    sh->fSt.waiterBusy = sh->fSt.waiterStall = 0;
+    sh->fSt.readyCount = sh->fSt.nBatches = sh->fSt.nTrips = 0;
+    sh->fSt.readyPending = false;
+    for (t = 0; t <= MAXORDERS; t++) {
+        sh->fSt.tripPlates[t] = 0;
+    }
+    sh->fSt.chefBusy = 0;
 
-    FILE *fp = fopen("config.txt","r");
+    FILE *fp = fopen(cfgName,"r");
     if(fp==NULL) {
         perror("Could not open config file");
         exit(EXIT_FAILURE);
     }
 
     /* parse config file */
-    fscanf(fp,"%*[^\n]");
-    fscanf(fp,"%d ",&sh->fSt.nGroups);
-    fscanf(fp,"%*[^\n]");
-    for(g=0;g < sh->fSt.nGroups;g++) {
-       fscanf(fp,"%d %d", &sh->fSt.startTime[g], &sh->fSt.eatTime[g]);
+    parseConfig (fp, &sh->fSt);
+    fclose (fp);
+
+    /* all tables are free; groups that cannot be seated are turned away at reception */
+    seatInit (&sh->fSt);
+    stationInit (&sh->fSt);                                                       /* kitchen station queues empty */
+    shelfInit (&sh->fSt);                                                            /* prep-ahead shelf empty */
+    sh->fSt.nServed = 0;
+    sh->fSt.nRejected = 0;
+    for (g = 0; g < sh->fSt.nGroups; g++) {
+        if (seatFeasible (&sh->fSt, sh->fSt.groupSize[g])) {
+            sh->fSt.nServed++;
+        }
     }
-   
+
+    /* every group visits once, unless in the continuous mode, where the groups come back until closing */
+    sh->fSt.closing = !sh->fSt.continuous;
+    sh->fSt.nVisits = sh->fSt.nGroups;
+    sh->fSt.nLeft = 0;
+    histInit (&sh->fSt.serveWindow);
+    for (g = 0; g < NPHASES; g++) {                                             /* no visit has ended yet */
+        histInit (&sh->fSt.visitPhase[g]);
+    }
+    histInit (&sh->fSt.visitTardiness);
+    sh->fSt.visitMissed = 0;
+
+    /* no timers posted yet */
+    memset (sh->fSt.timerRing, 0, sizeof (sh->fSt.timerRing));
+    sh->fSt.timerTail = 0;
+    sh->fSt.timerFired = sh->fSt.timerTicks = sh->fSt.timerVisits = 0;
+    histInit (&sh->fSt.wakeJitter);
+
     /* create log file */
     createLog (nFic, &sh->fSt);                                  
     saveState(nFic,&sh->fSt);
@@ -127,9 +452,18 @@ int main (int argc, char *argv[])
     sh->waiterRequest               = WAITERREQUEST;                                                      
     sh->waiterRequestPossible       = WAITERREQUESTPOSSIBLE;                                                      
     sh->waitOrder                   = WAITORDER;                                                      
-    sh->orderReceived               = ORDERRECEIVED;                                                      
-    for(g=0;g<sh->fSt.nGroups;g++) {
-       sh->waitForTable[g]          = WAITFORTABLE+g;                                                      
+    sh->orderSlot                   = ORDERSLOT;                                                      
+    sh->groupArrival                = GROUPARRIVAL;
+    sh->timerReq                    = TIMERREQ;
+    sh->stationOrder[ST_PREP]       = WAITORDER;                      /* the first station takes the kitchen orders */
+    sh->stationSlot[ST_PREP]        = ORDERSLOT;
+    for(t=ST_COOK;t<NSTATIONS;t++) {
+       sh->stationOrder[t]          = STATIONORDER+t;
+       sh->stationSlot[t]           = STATIONSLOT+t;
+    }
+    for(g=0;g<sh->fSt.nAgents;g++) {
+       sh->waitForTable[g]          = WAITFORTABLE+g;
+       sh->timerExpired[g]          = TIMEREXPIRED+g;                                                      
     }
     for(t=0;t<NUMTABLES;t++) {
        sh->foodArrived[t]           = FOODARRIVED+t;                                                      
@@ -154,13 +488,39 @@ int main (int argc, char *argv[])
         perror ("error on executing the up operation for semaphore access");
         exit (EXIT_FAILURE);
     }
+    for (t = 0; t < sh->fSt.orderQueueSize; t++) {                     /* kitchen order queue starts empty */
+        if (semUp (semgid, sh->orderSlot) == -1) {
+            perror ("error on executing the up operation for semaphore access");
+            exit (EXIT_FAILURE);
+        }
+    }
+    for (g = ST_COOK; g < NSTATIONS; g++) {                                   /* station queues start empty */
+        for (t = 0; t < sh->fSt.station[g].capacity; t++) {
+            if (semUp (semgid, sh->stationSlot[g]) == -1) {
+                perror ("error on executing the up operation for semaphore access");
+                exit (EXIT_FAILURE);
+            }
+        }
+    }
+
+#ifdef CSPROF
+    if (csprofCreate () == -1) {
+        perror ("error on creating the profiling region");
+        exit (EXIT_FAILURE);
+    }
+#endif
+
+    /* in the continuous mode SIGINT ends the service: the entities ignore it (they inherit the disposition) */
+    if (sh->fSt.continuous) {
+        signal (SIGINT, SIG_IGN);
+    }
 
     /* generation of intervening entities processes */                            
-    /* group processes */
+    /* group agent processes */
     strcpy (nFicErr + 6, "GR");
-    for (g = 0; g < sh->fSt.nGroups; g++) {           
+    for (g = 0; g < sh->fSt.nAgents; g++) {           
         if ((pidGR[g] = fork ()) < 0) {
-            perror ("error on the fork operation for the group");
+            perror ("error on the fork operation for the group agent");
             exit (EXIT_FAILURE);
         }
         sprintf(num[0],"%d",g);
@@ -208,21 +568,94 @@ int main (int argc, char *argv[])
         }
 
     /* signaling start of operations */
+    sh->fSt.runStart = sh->fSt.lastSeatChange = timeNow ();
+    for (g = 0; g < sh->fSt.nGroups; g++) {
+        clearGroupTimes (&sh->fSt, g, sh->fSt.runStart);                       /* the first visits start now */
+        setGroupTime (&sh->fSt, g, GOTOREST, sh->fSt.runStart);
+    }
+    arrivalInit (&sh->fSt);                                        /* all groups due, in the order of their start times */
+    /* one up per queued group, and one more once closing: an agent that finds the queue empty passes it on */
+    for (g = 0; g < sh->fSt.nGroups + (sh->fSt.closing ? 1 : 0); g++) {
+        if (semUp (semgid, sh->groupArrival) == -1) {
+            perror ("error on executing the up operation for semaphore access");
+            exit (EXIT_FAILURE);
+        }
+    }
     if (semSignal (semgid) == -1) {
         perror ("error on signaling start of operations");
         exit (EXIT_FAILURE);
     }
 
+    /* timer thread: wakes the group agents, if they do not sleep by themselves */
+    if (sh->fSt.timerTick > 0) {
+        timerStart (sh, semgid);
+    }
+
+    /* continuous mode: serving until the end of service, with measurements per window */
+    if (sh->fSt.continuous) {
+        staff[0] = pidCH;
+        staff[1] = pidWT;
+        staff[2] = pidRT;
+        soakRun (stdout, sh, semgid, staff);
+    }
+
     /* waiting for the termination of the intervening entities processes */
     m = 0;
     do {
-        info = wait (&status);
+        info = wait4 (-1, &status, 0, &ru);
+        if ((info == -1) && (errno == EINTR)) {                  /* another end of service signal, in the continuous mode */
+            continue;
+        }
         if (info == -1) { 
             perror ("error on aiting for an intervening process");
             exit (EXIT_FAILURE);
         }
+        if (info == pidCH) u = &sh->fSt.usage[U_CHEF];
+        else if (info == pidWT) u = &sh->fSt.usage[U_WAITER];
+        else if (info == pidRT) u = &sh->fSt.usage[U_RECEPTIONIST];
+        else for (u = NULL, g = 0; g < sh->fSt.nAgents; g++) {
+            if (info == pidGR[g]) {
+                u = &sh->fSt.usage[U_GROUP+g];
+                if ((++nGone == sh->fSt.nAgents) && sh->fSt.continuous) {
+                    soakClose (sh, semgid);                 /* all group agents gone: the staff may terminate */
+                }
+            }
+        }
+        if (u != NULL) {
+            u->pid = info;
+            u->utime = ru.ru_utime.tv_sec * 1000000LL + ru.ru_utime.tv_usec;
+            u->stime = ru.ru_stime.tv_sec * 1000000LL + ru.ru_stime.tv_usec;
+            u->nvcsw = ru.ru_nvcsw;
+            u->nivcsw = ru.ru_nivcsw;
+        }
+        if (!WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+            fprintf (stderr, "process %d terminated abnormally (status 0x%x)\n", info, status);
+        }
         m += 1;
-    } while (m < 3+sh->fSt.nGroups);
+    } while (m < 3+sh->fSt.nAgents);
+
+    runEnd = timeNow ();
+    if (sh->fSt.timerTick > 0) {
+        timerStop ();
+    }
+    traceFinish ();
+    printReport (stdout, &sh->fSt, runEnd);
+    if (nRec != NULL) {
+        if ((fp = fopen (nRec, "w")) == NULL) {
+            perror ("error on creating the record file");
+            exit (EXIT_FAILURE);
+        }
+        saveRecord (fp, &sh->fSt, runEnd);
+        fclose (fp);
+    }
+
+#ifdef CSPROF
+    csprofReport (stdout);
+    if (csprofDestroy () == -1) {
+        perror ("error on destructing the profiling region");
+        exit (EXIT_FAILURE);
+    }
+#endif
 
     /* destruction of semaphore set and shared region */
     if (semDestroy (semgid) == -1) {
@@ -0,0 +1,39 @@
+/**
+ *  \file probes.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Static tracepoints (USDT) of the life cycle functions of the intervening entities.
+ *
+ *  Every life cycle function has an <tt>entry</tt> and a <tt>return</tt> probe of provider <tt>restaurant</tt>,
+ *  named after the function (e.g. <tt>restaurant:waitForGroup__entry</tt>, shown as <tt>waitForGroup-entry</tt>
+ *  by some tools). External tracers (bpftrace, perf, SystemTap) can attach to them in unmodified runs and measure
+ *  the latency of each function without logging.
+ *
+ *  The probes are compiled out unless USDT is defined (<tt>make usdt</tt>, which needs <tt>sys/sdt.h</tt>,
+ *  e.g. from systemtap-sdt-dev). Enabled, a probe is a single nop until a tracer attaches.
+ */
+
+#ifndef PROBES_H_
+#define PROBES_H_
+
+#ifdef USDT
+
+#include <sys/sdt.h>
+
+/** \brief probe without arguments */
+#define PROBE0(name)                DTRACE_PROBE (restaurant, name)
+/** \brief probe with one argument */
+#define PROBE1(name, a1)            DTRACE_PROBE1 (restaurant, name, a1)
+/** \brief probe with two arguments */
+#define PROBE2(name, a1, a2)        DTRACE_PROBE2 (restaurant, name, a1, a2)
+
+#else
+
+#define PROBE0(name)                do { } while (0)
+#define PROBE1(name, a1)            do { } while (0)
+#define PROBE2(name, a1, a2)        do { } while (0)
+
+#endif /* USDT */
+
+#endif /* PROBES_H_ */
@@ -0,0 +1,283 @@
+/**
+ *  \file report.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Summary of a simulation run.
+ *
+ *  Defined operations:
+ *     \li printing the summary of the run, computed from the final full state
+ *     \li saving a machine-readable record of the run.
+ *
+ *  Lifecycle latencies and tardiness are taken from the histograms every visit records as it ends (see
+ *  histogram.h and lifecycle.h), so that in the continuous mode they cover all visits, not only the last visit
+ *  of each group (the windowed measurements are printed by the launcher, see soak.h).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "seating.h"
+#include "orderQueue.h"
+#include "kitchen.h"
+#include "histogram.h"
+#include "lifecycle.h"
+
+/** \brief ratio as a percentage (0 if the denominator is null) */
+static double percent (double num, double den)
+{
+    return (den > 0.0) ? 100.0 * num / den : 0.0;
+}
+
+/** \brief mean of the values (us) recorded in a histogram, in ms (0 if empty) */
+static double meanMs (HISTOGRAM *h)
+{
+    return (h->n > 0) ? h->sum / h->n / 1e3 : 0.0;
+}
+
+/** \brief seats, groups served and rejections */
+static void reportSeating (FILE *fic, FULL_STAT *p_fSt, long long elapsed)
+{
+    int t, seats = 0;
+
+    for (t = 0; t < NUMTABLES; t++) {
+        seats += p_fSt->tableCapacity[t];
+    }
+    fprintf (fic, "  seat policy        : %s\n", seatPolicyName (p_fSt->seatPolicy));
+    fprintf (fic, "  group agents       : %d for %d groups\n", p_fSt->nAgents, p_fSt->nGroups);
+    fprintf (fic, "  %-19s: %d of %d\n", p_fSt->continuous ? "visits served" : "groups served",
+             p_fSt->nVisits - p_fSt->nRejected, p_fSt->nVisits);
+    fprintf (fic, "  rejection rate     : %.1f%%\n", percent (p_fSt->nRejected, p_fSt->nVisits));
+    fprintf (fic, "  seat utilisation   : %.1f%% (people seated / %d seats)\n",
+             percent (p_fSt->seatUsage, (double) seats * elapsed), seats);
+    fprintf (fic, "  packing efficiency : %.1f%% (people seated / seats of occupied tables)\n",
+             percent (p_fSt->seatUsage, p_fSt->occupiedUsage));
+}
+
+/** \brief kitchen queue, batches and order latency (food request reaching the kitchen -> food ready) */
+static void reportKitchen (FILE *fic, FULL_STAT *p_fSt)
+{
+    HISTOGRAM *lat = &p_fSt->visitPhase[PH_KITCHEN];
+    int d;
+
+    fprintf (fic, "  kitchen queue      : %d of %d orders at most\n", p_fSt->orderQueueMax, p_fSt->orderQueueSize);
+    fprintf (fic, "  kitchen batches    : %d, %.2f orders per batch (max %d, window %d us, +%d us per order)\n",
+             p_fSt->nBatches, (p_fSt->nBatches > 0) ? (double) p_fSt->station[ST_COOK].taken / p_fSt->nBatches : 0.0,
+             p_fSt->maxBatch, p_fSt->batchWindow, p_fSt->cookPerDish);
+    fprintf (fic, "  menu (portions)    :");
+    for (d = 0; d < p_fSt->nDishes; d++) {
+        fprintf (fic, "%s dish %d (%d+-%d us) x%d", (d > 0) ? "," : "", d, p_fSt->dishMean[d], p_fSt->dishDev[d],
+                 p_fSt->dishPortions[d]);
+    }
+    fprintf (fic, "\n");
+    fprintf (fic, "  order payloads     : %d portions, %u blocks allocated (peak %u in use, %u failed, %u not freed)\n",
+             p_fSt->nPortions, p_fSt->slab.nAlloc, p_fSt->slab.peak, p_fSt->slab.nFailed, p_fSt->slab.inUse);
+    fprintf (fic, "  kitchen throughput : %.1f orders per second of cooking\n",
+             (p_fSt->chefBusy > 0) ? p_fSt->station[ST_COOK].taken * 1e6 / p_fSt->chefBusy : 0.0);
+    fprintf (fic, "  kitchen latency    : mean %.3f ms, p50 %.3f ms, p99 %.3f ms (order taken -> food ready)\n",
+             meanMs (lat), histPercentile (lat, 50.0) / 1e3, histPercentile (lat, 99.0) / 1e3);
+}
+
+/** \brief utilisation and queue depth of the stations of the kitchen pipeline, naming the bottleneck */
+static void reportStations (FILE *fic, FULL_STAT *p_fSt, long long elapsed)
+{
+    double util[NSTATIONS];
+    int s, worst = 0;
+
+    fprintf (fic, "  kitchen stations   : %-6s %7s %8s %6s %6s %10s %9s %10s\n", "", "workers", "capacity", "jobs",
+             "util", "mean depth", "max depth", "blocked ms");
+    for (s = 0; s < NSTATIONS; s++) {
+        STATION *st = &p_fSt->station[s];
+
+        util[s] = (elapsed > 0) ? 100.0 * st->busy / ((double) st->workers * elapsed) : 0.0;
+        if (util[s] > util[worst]) worst = s;
+        fprintf (fic, "                       %-6s %7d %8d %6d %5.1f%% %10.2f %9d %10.3f\n", stationName (s),
+                 st->workers, st->capacity, st->taken, util[s], (elapsed > 0) ? (double) st->depthUsage / elapsed : 0.0,
+                 st->maxCount, st->blocked / 1e3);
+    }
+    fprintf (fic, "  bottleneck         : %s (%.1f%% busy)\n", stationName (worst), util[worst]);
+}
+
+/** \brief hit rate, waste and latency saved by the prep-ahead shelf */
+static void reportShelf (FILE *fic, FULL_STAT *p_fSt)
+{
+    SHELF *sf = &p_fSt->shelf;
+
+    if (sf->capacity == 0) {
+        fprintf (fic, "  prep-ahead shelf   : off\n");
+        return;
+    }
+    fprintf (fic, "  prep-ahead shelf   : %d portions, spoil after %d us, pre-cook after %d us idle (%.3f ms pre-cooking)\n",
+             sf->capacity, sf->spoil, sf->idle, sf->busy / 1e3);
+    fprintf (fic, "  shelf hits         : %d of %d portions (%.1f%%), %d orders served entirely from the shelf\n",
+             sf->nHits, sf->nDemand, percent (sf->nHits, sf->nDemand), sf->nOrderHits);
+    fprintf (fic, "  shelf waste        : %d of %d portions pre-cooked (%d spoiled, %d left at the end)\n",
+             sf->nSpoiled + sf->count, sf->nCooked, sf->nSpoiled, sf->count);
+    fprintf (fic, "  latency saved      : %.3f ms of cooking taken off the orders (served from the shelf)\n", sf->saved / 1e3);
+}
+
+/** \brief deadline misses and tardiness (how late the food was ready with respect to the deadline) */
+static void reportDeadlines (FILE *fic, FULL_STAT *p_fSt)
+{
+    HISTOGRAM *tard = &p_fSt->visitTardiness;
+
+    fprintf (fic, "  kitchen policy     : %s, service target %d us after sitting down\n",
+             kitchenPolicyName (p_fSt->kitchenPolicy), p_fSt->serviceTarget);
+    fprintf (fic, "  deadline misses    : %d of %lld (%.1f%%)\n", p_fSt->visitMissed, tard->n,
+             percent (p_fSt->visitMissed, tard->n));
+    fprintf (fic, "  tardiness          : mean %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+             meanMs (tard), histPercentile (tard, 50.0) / 1e3, histPercentile (tard, 90.0) / 1e3,
+             histPercentile (tard, 99.0) / 1e3, tard->max / 1e3);
+}
+
+/** \brief waiter utilisation, trips and food wait (food ready -> food at the table) */
+static void reportWaiter (FILE *fic, FULL_STAT *p_fSt, long long elapsed)
+{
+    HISTOGRAM *wait = &p_fSt->visitPhase[PH_DELIVERY];
+    long long plates = 0;
+    int k;
+
+    for (k = 1; k <= p_fSt->maxPlates; k++) {                         /* every trip counts, whatever the visit */
+        plates += (long long) k * p_fSt->tripPlates[k];
+    }
+    fprintf (fic, "  waiter utilisation : %.2f%% busy (%.3f ms), %.3f ms of it blocked on the kitchen\n",
+             percent (p_fSt->waiterBusy, elapsed), p_fSt->waiterBusy / 1e3, p_fSt->waiterStall / 1e3);
+    fprintf (fic, "  waiter trips       : %d, %.2f plates per trip (max %d, %d us per trip)\n",
+             p_fSt->nTrips, (p_fSt->nTrips > 0) ? (double) plates / p_fSt->nTrips : 0.0, p_fSt->maxPlates, p_fSt->tripTime);
+    fprintf (fic, "  plates per trip    :");
+    for (k = 1; k <= p_fSt->maxPlates; k++) {
+        if (p_fSt->tripPlates[k] > 0) {
+            fprintf (fic, " %d x%d", k, p_fSt->tripPlates[k]);
+        }
+    }
+    fprintf (fic, "\n");
+    fprintf (fic, "  food wait          : mean %.3f ms, p50 %.3f ms, p99 %.3f ms (food ready -> food at table)\n",
+             meanMs (wait), histPercentile (wait, 50.0) / 1e3, histPercentile (wait, 99.0) / 1e3);
+}
+
+/** \brief latency of each phase of the lifecycle of the groups */
+static void reportLifecycle (FILE *fic, FULL_STAT *p_fSt)
+{
+    HISTOGRAM *h;
+    int ph;
+
+    fprintf (fic, "  lifecycle (ms)     : %-10s %6s %9s %9s %9s %9s %9s\n", "phase", "visits", "min", "p50", "p90", "p99", "max");
+    for (ph = 0; ph < NPHASES; ph++) {
+        h = &p_fSt->visitPhase[ph];
+        fprintf (fic, "                       %-10s %6lld %9.3f %9.3f %9.3f %9.3f %9.3f\n", phaseName (ph), h->n,
+                 h->min / 1e3, histPercentile (h, 50.0) / 1e3, histPercentile (h, 90.0) / 1e3,
+                 histPercentile (h, 99.0) / 1e3, h->max / 1e3);
+    }
+}
+
+/** \brief resource usage of one process */
+static void reportProcess (FILE *fic, const char *name, USAGE *u)
+{
+    fprintf (fic, "                       %-14s %7d %10.3f %10.3f %8ld %9ld %9lld\n", name, u->pid,
+             u->utime / 1e3, u->stime / 1e3, u->nvcsw, u->nivcsw, u->semOps);
+}
+
+/** \brief how the group agents are woken up from their sleeps, and how late */
+static void reportWakeups (FILE *fic, FULL_STAT *p_fSt)
+{
+    HISTOGRAM *h = &p_fSt->wakeJitter;
+
+    if (p_fSt->timerTick == 0) {
+        fprintf (fic, "  wake-ups           : each group agent sleeps by itself\n");
+    }
+    else fprintf (fic, "  wake-ups           : timer wheel of %d slots of %d us, %lld timers fired, %.2f looked at per tick\n",
+                  p_fSt->timerSlots, p_fSt->timerTick, p_fSt->timerFired,
+                  (p_fSt->timerTicks > 0) ? (double) p_fSt->timerVisits / p_fSt->timerTicks : 0.0);
+    fprintf (fic, "  wake-up jitter     : p50 %lld us, p99 %lld us, max %lld us (%lld sleeps, expiry -> agent awake)\n",
+             histPercentile (h, 50.0), histPercentile (h, 99.0), h->max, h->n);
+}
+
+/** \brief CPU time, context switches and semaphore operations of the process of each entity */
+static void reportUsage (FILE *fic, FULL_STAT *p_fSt)
+{
+    USAGE tot = { 0 };
+    char name[24];
+    int s;
+
+    fprintf (fic, "  processes          : %-14s %7s %10s %10s %8s %9s %9s\n", "entity", "pid", "user ms", "sys ms",
+             "vol csw", "invol csw", "sem ops");
+    reportProcess (fic, "chef", &p_fSt->usage[U_CHEF]);
+    reportProcess (fic, "waiter", &p_fSt->usage[U_WAITER]);
+    reportProcess (fic, "receptionist", &p_fSt->usage[U_RECEPTIONIST]);
+    for (s = U_GROUP; s < U_GROUP + p_fSt->nAgents; s++) {
+        snprintf (name, sizeof (name), "group agent %d", s - U_GROUP);
+        reportProcess (fic, name, &p_fSt->usage[s]);
+    }
+    for (s = 0; s < U_GROUP + p_fSt->nAgents; s++) {
+        tot.utime += p_fSt->usage[s].utime;
+        tot.stime += p_fSt->usage[s].stime;
+        tot.nvcsw += p_fSt->usage[s].nvcsw;
+        tot.nivcsw += p_fSt->usage[s].nivcsw;
+        tot.semOps += p_fSt->usage[s].semOps;
+    }
+    fprintf (fic, "                       %-14s %7s %10.3f %10.3f %8ld %9ld %9lld\n", "total", "",
+             tot.utime / 1e3, tot.stime / 1e3, tot.nvcsw, tot.nivcsw, tot.semOps);
+}
+
+/**
+ *  \brief Printing the summary of the run.
+ *
+ *  Must be called after all intervening entities have terminated.
+ *
+ *  \param fic stream where the summary is printed
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param runEnd time stamp (us) of the end of operations
+ */
+void printReport (FILE *fic, FULL_STAT *p_fSt, long long runEnd)
+{
+    long long elapsed = runEnd - p_fSt->runStart;
+
+    fprintf (fic, "\nRun summary (%.3f s)\n", elapsed / 1e6);
+    reportSeating (fic, p_fSt, elapsed);
+    reportKitchen (fic, p_fSt);
+    reportStations (fic, p_fSt, elapsed);
+    reportShelf (fic, p_fSt);
+    reportDeadlines (fic, p_fSt);
+    reportWaiter (fic, p_fSt, elapsed);
+    reportWakeups (fic, p_fSt);
+    reportLifecycle (fic, p_fSt);
+    reportUsage (fic, p_fSt);
+}
+
+/**
+ *  \brief Saving a machine-readable record of the run.
+ *
+ *  One line with the number of groups, served groups, rejected groups and the elapsed time,
+ *  followed by one line per served group with its size and the latency (us) of each phase of its
+ *  lifecycle (of its last visit, in the continuous mode), in the order defined in lifecycle.h. Lines
+ *  starting with '#' are comments.
+ *
+ *  Must be called after all intervening entities have terminated.
+ *
+ *  \param fic stream where the record is saved
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param runEnd time stamp (us) of the end of operations
+ */
+void saveRecord (FILE *fic, FULL_STAT *p_fSt, long long runEnd)
+{
+    int g, ph;
+
+    fprintf (fic, "# run groups served rejected elapsed\n");
+    fprintf (fic, "run %d %d %d %lld\n", p_fSt->nGroups, p_fSt->nServed, p_fSt->nRejected, runEnd - p_fSt->runStart);
+    fprintf (fic, "# group id size");
+    for (ph = 0; ph < NPHASES; ph++) {
+        fprintf (fic, " %s", phaseName (ph));
+    }
+    fprintf (fic, "\n");
+    for (g = 0; g < p_fSt->nGroups; g++) {
+        if (groupTime (p_fSt, g, EAT) != 0) {
+            fprintf (fic, "group %d %d", g, p_fSt->groupSize[g]);
+            for (ph = 0; ph < NPHASES; ph++) {
+                fprintf (fic, " %lld", phaseLatency (p_fSt, g, ph));
+            }
+            fprintf (fic, "\n");
+        }
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ *  \file report.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Summary of a simulation run.
+ *
+ *  Defined operations:
+ *     \li printing the summary of the run, computed from the final full state
+ *     \li saving a machine-readable record of the run.
+ */
+
+#ifndef REPORT_H_
+#define REPORT_H_
+
+#include <stdio.h>
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Printing the summary of the run.
+ *
+ *  Must be called after all intervening entities have terminated.
+ *
+ *  \param fic stream where the summary is printed
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param runEnd time stamp (us) of the end of operations
+ */
+extern void printReport (FILE *fic, FULL_STAT *p_fSt, long long runEnd);
+
+/**
+ *  \brief Saving a machine-readable record of the run.
+ *
+ *  One line with the number of groups, served groups, rejected groups and the elapsed time,
+ *  followed by one line per served group with its size and the latency (us) of each phase of its
+ *  lifecycle, in the order defined in lifecycle.h. Lines starting with '#' are comments.
+ *
+ *  Must be called after all intervening entities have terminated.
+ *
+ *  \param fic stream where the record is saved
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param runEnd time stamp (us) of the end of operations
+ */
+extern void saveRecord (FILE *fic, FULL_STAT *p_fSt, long long runEnd);
+
+#endif /* REPORT_H_ */
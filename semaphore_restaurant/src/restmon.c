@@ -0,0 +1,196 @@
+/**
+ *  \file restmon.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  Live monitor of a running simulation.
+ *
+ *  Attaches the shared region of the simulation running in the present directory read-only and refreshes,
+ *  a few times per second, a view of the entity states, the kitchen queue, the table occupancy and the
+ *  throughput. The mutex is never taken, so the timing of the simulation is not perturbed: each refresh
+ *  works on a consistent snapshot obtained with the sequence counter of the shared region (see sharedDataSync.h).
+ *  The monitor waits for a simulation to start and terminates when the shared region is destroyed.
+ *
+ *  Usage: restmon [-i interval (ms)] [-n number of refreshes]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "sharedMemory.h"
+#include "timing.h"
+
+/** \brief default refresh interval (ms) */
+#define  DEFINTERVAL        250
+
+/** \brief attempts to take a consistent snapshot before giving up on a refresh */
+#define  MAXTRIES           1000
+
+/** \brief names of the chef states */
+static const char *chefStates[] = { "WAIT_FOR_ORDER", "COOK", "REST" };
+
+/** \brief names of the waiter states */
+static const char *waiterStates[] = { "WAIT_FOR_REQUEST", "INFORM_CHEF", "TAKE_TO_TABLE" };
+
+/** \brief names of the receptionist states */
+static const char *receptionistStates[] = { "WAIT_FOR_REQUEST", "ASSIGNTABLE", "RECVPAY" };
+
+/** \brief names of the group states */
+static const char *groupStates[] = { "?", "GOTOREST", "ATRECEPTION", "FOOD_REQUEST", "WAIT_FOR_FOOD", "EAT",
+                                     "CHECKOUT", "LEAVING" };
+
+/** \brief names of the kitchen stations */
+static const char *stationNames[] = { "prep", "cook", "plate" };
+
+/** \brief name of a state (bounds checked, the snapshot is not trusted blindly) */
+#define  NAME(tab, s)       (((s) < sizeof (tab) / sizeof (tab[0])) ? tab[s] : "?")
+
+/* internal functions */
+
+/** \brief consistent copy of the shared region, taken without the mutex */
+static bool snapshot (SHARED_DATA *sh, SHARED_DATA *copy, int *tries)
+{
+    unsigned int s1, s2;
+
+    for (*tries = 1; *tries <= MAXTRIES; (*tries)++) {
+        s1 = __atomic_load_n (&sh->seq, __ATOMIC_ACQUIRE);
+        if ((s1 & 1) == 0) {
+            memcpy (copy, sh, sizeof (SHARED_DATA));
+            __atomic_thread_fence (__ATOMIC_ACQUIRE);
+            s2 = __atomic_load_n (&sh->seq, __ATOMIC_RELAXED);
+            if (s1 == s2) {
+                return true;
+            }
+        }
+        sched_yield ();                                                             /* a writer is in its region */
+    }
+    return false;
+}
+
+/** \brief number of groups that have eaten and left */
+static int groupsDone (FULL_STAT *p)
+{
+    int g, n = 0;
+
+    for (g = 0; g < p->nGroups; g++) {
+        if ((groupTime (p, g, EAT) != 0) && (groupTime (p, g, LEAVING) != 0)) {
+            n++;
+        }
+    }
+    return n;
+}
+
+/** \brief one refresh of the view */
+static void display (FULL_STAT *p, int tries, double elapsed, double rate)
+{
+    int g, t;
+
+    printf ("\033[H\033[2J");
+    printf ("restmon  %.3f s elapsed  (snapshot after %d attempt%s)\n\n", elapsed, tries, (tries > 1) ? "s" : "");
+    printf ("chef: %-16s waiter: %-16s receptionist: %s\n\n", NAME (chefStates, p->st.chefStat),
+            NAME (waiterStates, p->st.waiterStat), NAME (receptionistStates, p->st.receptionistStat));
+
+    printf ("tables      :");
+    for (t = 0; t < NUMTABLES; t++) {
+        if (p->tableGroup[t] == -1) {
+            printf ("  %d[%d] free", t, p->tableCapacity[t]);
+        }
+        else printf ("  %d[%d] group %d", t, p->tableCapacity[t], p->tableGroup[t]);
+    }
+    printf ("\n");
+    printf ("seats       : %d people in %d occupied seats\n", p->seatedPeople, p->occupiedSeats);
+    printf ("waiting room: %d groups\n", p->groupsWaiting);
+    printf ("kitchen     : %d of %d orders queued (max %d), %d batches, %d plates ready\n",
+            p->orderCount, p->orderQueueSize, p->orderQueueMax, p->nBatches, p->readyCount);
+    printf ("stations    :");
+    for (t = 0; t < NSTATIONS; t++) {
+        printf ("  %s %d of %d queued (%d taken)", stationNames[t], p->station[t].count, p->station[t].capacity,
+                p->station[t].taken);
+    }
+    printf ("\n");
+    printf ("waiter      : %d trips\n", p->nTrips);
+    printf ("groups      : %d of %d done, %d turned away, %.1f groups/s over the last refresh\n\n",
+            groupsDone (p), p->nGroups, p->nRejected, rate);
+
+    printf ("%5s %5s %-14s %6s\n", "group", "size", "state", "table");
+    for (g = 0; g < p->nGroups; g++) {
+        printf ("%5d %5d %-14s ", g, p->groupSize[g], NAME (groupStates, groupState (p, g)));
+        if (groupTable (p, g) != -1) {
+            printf ("%6d\n", groupTable (p, g));
+        }
+        else printf ("%6s\n", ".");
+    }
+    fflush (stdout);
+}
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to attach the shared region read-only and refresh the view until the simulation ends.
+ */
+int main (int argc, char *argv[])
+{
+    static SHARED_DATA copy;                                                         /* snapshot of the shared region */
+    SHARED_DATA *sh;                                                                /* pointer to shared memory region */
+    int key, shmid, interval = DEFINTERVAL, count = 0, n, tries, done, lastDone = 0, opt;
+    long long now, last;
+
+    while ((opt = getopt (argc, argv, "i:n:")) != -1) {
+        switch (opt) {
+            case 'i': interval = atoi (optarg);
+                      break;
+            case 'n': count = atoi (optarg);
+                      break;
+            default:  fprintf (stderr, "Usage: %s [-i interval (ms)] [-n number of refreshes]\n", argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if (interval < 1) {
+        fprintf (stderr, "the refresh interval must be positive\n");
+        exit (EXIT_FAILURE);
+    }
+
+    if ((key = ftok (".", 'a')) == -1) {
+        perror ("error on generating the key");
+        exit (EXIT_FAILURE);
+    }
+    while ((shmid = shmemConnect (key)) == -1) {                                    /* waiting for a simulation */
+        usleep (interval * 1000);
+    }
+    if (shmemAttachReadOnly (shmid, (void **) &sh) == -1) {
+        perror ("error on mapping the shared region on the process address space");
+        exit (EXIT_FAILURE);
+    }
+
+    last = timeNow ();
+    for (n = 0; (count == 0) || (n < count); n++) {
+        if (snapshot (sh, &copy, &tries)) {
+            now = timeNow ();
+            done = groupsDone (&copy.fSt);
+            display (&copy.fSt, tries, (copy.fSt.runStart != 0) ? (now - copy.fSt.runStart) / 1e6 : 0.0,
+                     (done - lastDone) * 1e6 / (now - last));
+            lastDone = done;
+            last = now;
+        }
+        if (shmemConnect (key) != shmid) {                                       /* the simulation has ended */
+            break;
+        }
+        usleep (interval * 1000);
+    }
+
+    if (shmemDettach (sh) == -1) {
+        perror ("error on unmapping the shared region off the process address space");
+        exit (EXIT_FAILURE);
+    }
+
+    return EXIT_SUCCESS;
+}
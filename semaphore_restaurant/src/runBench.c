@@ -0,0 +1,175 @@
+/**
+ *  \file runBench.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  End-to-end benchmark driver.
+ *
+ *  Runs the simulation for a matrix of config files and repetitions and measures, for every run, the wall time,
+ *  the CPU time and the voluntary and involuntary context switches of the launcher and all the entities,
+ *  besides the latency of each phase of the lifecycle of every group (see lifecycle.h).
+ *  For each config file the median and 99th percentile of every measurement are printed and saved
+ *  as JSON, so that changes to the synchronization code can be judged on numbers.
+ *
+ *  Usage: runBench [-n repetitions] [-o report] [-l logfile] config ...
+ *
+ *  The exit status is EXIT_FAILURE if any run failed.
+ *
+ *  Must be executed in the directory of the binaries.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "probConst.h"
+#include "runner.h"
+#include "stats.h"
+
+/** \brief default number of repetitions of each config */
+#define  DEFREPS            20
+
+/** \brief number of run measurements (wall, cpu, voluntary and involuntary context switches) */
+#define  NMEAS              4
+
+/** \brief names of the run measurements */
+static const char *measName[NMEAS] = { "wall_us", "cpu_us", "voluntary_csw", "involuntary_csw" };
+
+/** \brief measurements of every run of a config */
+typedef struct {
+    int nRuns,                                                                         /* number of successful runs */
+        nFailed;                                                                           /* number of failed runs */
+    double *meas[NMEAS];                                                               /* run measurements, per run */
+    int nPhase;                                                                  /* number of phase latency samples */
+    double *phase[NPHASES];                                                       /* phase latencies, per group (us) */
+} SERIES;
+
+/** \brief median and 99th percentile of a sample */
+static void writeStat (FILE *fp, const char *name, double v[], int n, const char *sep)
+{
+    double p50 = statPercentile (v, n, 50.0),
+           p99 = statPercentile (v, n, 99.0);
+
+    fprintf (fp, "        \"%s\": {\"median\": %.1f, \"p99\": %.1f, \"samples\": %d}%s\n", name, p50, p99, n, sep);
+}
+
+/** \brief running all repetitions of a config */
+static void runSeries (const char *config, const char *log, int nReps, SERIES *s)
+{
+    RUNRESULT r;
+    int i, m, p, k;
+
+    s->nRuns = s->nFailed = s->nPhase = 0;
+    for (m = 0; m < NMEAS; m++) {
+        if ((s->meas[m] = malloc (nReps * sizeof (double))) == NULL) {
+            perror ("error on allocating the measurements");
+            exit (EXIT_FAILURE);
+        }
+    }
+    for (p = 0; p < NPHASES; p++) {
+        if ((s->phase[p] = malloc (nReps * MAXGROUPS * sizeof (double))) == NULL) {
+            perror ("error on allocating the measurements");
+            exit (EXIT_FAILURE);
+        }
+    }
+    for (i = 0; i < nReps; i++) {
+        fprintf (stderr, "\r%s: run %d/%d", config, i + 1, nReps);
+        if (runOnce (NULL, config, log, 0, &r) == -1) {
+            s->nFailed += 1;
+            continue;
+        }
+        s->meas[0][s->nRuns] = (double) r.wall;
+        s->meas[1][s->nRuns] = (double) r.cpu;
+        s->meas[2][s->nRuns] = (double) r.nvcsw;
+        s->meas[3][s->nRuns] = (double) r.nivcsw;
+        s->nRuns += 1;
+        for (k = 0; k < r.nSamples; k++) {
+            for (p = 0; p < NPHASES; p++) {
+                s->phase[p][s->nPhase] = (double) r.phase[p][k];
+            }
+            s->nPhase += 1;
+        }
+    }
+    fprintf (stderr, "\n");
+}
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to run every config the requested number of times and report the measurements.
+ */
+int main (int argc, char *argv[])
+{
+    char *nRep = "runBench.json",                                                       /* name of the report file */
+         *nLog = "runBench.log";                                            /* name of the logging file of the runs */
+    int nReps = DEFREPS, nCfg, nFailed = 0, c, m, p, opt;
+    SERIES *s;
+    FILE *fp;
+
+    while ((opt = getopt (argc, argv, "n:o:l:")) != -1) {
+        switch (opt) {
+            case 'n': nReps = atoi (optarg);
+                      break;
+            case 'o': nRep = optarg;
+                      break;
+            case 'l': nLog = optarg;
+                      break;
+            default:  fprintf (stderr, "Usage: %s [-n repetitions] [-o report] [-l logfile] config ...\n", argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if ((nReps < 1) || (optind == argc)) {
+        fprintf (stderr, "Usage: %s [-n repetitions] [-o report] [-l logfile] config ...\n", argv[0]);
+        exit (EXIT_FAILURE);
+    }
+    nCfg = argc - optind;
+    if ((s = malloc (nCfg * sizeof (SERIES))) == NULL) {
+        perror ("error on allocating the measurements");
+        exit (EXIT_FAILURE);
+    }
+    for (c = 0; c < nCfg; c++) {
+        runSeries (argv[optind+c], nLog, nReps, &s[c]);
+        nFailed += s[c].nFailed;
+    }
+
+    /* human readable summary */
+    printf ("%-24s %5s %6s %12s %12s %12s %12s\n", "config", "runs", "failed", "wall p50", "wall p99", "cpu p50", "cpu p99");
+    for (c = 0; c < nCfg; c++) {
+        printf ("%-24s %5d %6d %12.0f %12.0f %12.0f %12.0f\n", argv[optind+c], s[c].nRuns, s[c].nFailed,
+                statPercentile (s[c].meas[0], s[c].nRuns, 50.0), statPercentile (s[c].meas[0], s[c].nRuns, 99.0),
+                statPercentile (s[c].meas[1], s[c].nRuns, 50.0), statPercentile (s[c].meas[1], s[c].nRuns, 99.0));
+    }
+
+    /* machine-readable report */
+    if ((fp = fopen (nRep, "w")) == NULL) {
+        perror ("error on creating the report file");
+        exit (EXIT_FAILURE);
+    }
+    fprintf (fp, "{\n  \"repetitions\": %d,\n  \"configs\": [\n", nReps);
+    for (c = 0; c < nCfg; c++) {
+        fprintf (fp, "    {\n      \"config\": \"%s\",\n      \"runs\": %d,\n      \"failed\": %d,\n      \"measurements\": {\n",
+                 argv[optind+c], s[c].nRuns, s[c].nFailed);
+        for (m = 0; m < NMEAS; m++) {
+            writeStat (fp, measName[m], s[c].meas[m], s[c].nRuns, (m < NMEAS - 1) ? "," : "");
+        }
+        fprintf (fp, "      },\n      \"phases_us\": {\n");
+        for (p = 0; p < NPHASES; p++) {
+            writeStat (fp, phaseName (p), s[c].phase[p], s[c].nPhase, (p < NPHASES - 1) ? "," : "");
+        }
+        fprintf (fp, "      }\n    }%s\n", (c < nCfg - 1) ? "," : "");
+    }
+    fprintf (fp, "  ]\n}\n");
+    fclose (fp);
+
+    for (c = 0; c < nCfg; c++) {
+        for (m = 0; m < NMEAS; m++) {
+            free (s[c].meas[m]);
+        }
+        for (p = 0; p < NPHASES; p++) {
+            free (s[c].phase[p]);
+        }
+    }
+    free (s);
+
+    return (nFailed > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
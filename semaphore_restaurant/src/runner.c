@@ -0,0 +1,196 @@
+/**
+ *  \file runner.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Measured execution of a simulation run.
+ *
+ *  Defined operations:
+ *     \li running the simulation once and collecting its measurements.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/sem.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "probConst.h"
+#include "timing.h"
+#include "sharedMemory.h"
+#include "runner.h"
+
+/** \brief name of the launcher */
+#define  LAUNCHER           "./probSemSharedMemRestaurant"
+
+/** \brief maximum length of a line of the record file */
+#define  RECLEN             256
+
+/* internal functions */
+
+/** \brief handler of SIGALRM: only cuts the wait for the launcher short */
+static void watchdog (int sig)
+{
+}
+
+/** \brief removal of the semaphore set and the shared region a failed run left behind in directory dir */
+static void removeStale (const char *dir)
+{
+    int key, id;
+
+    if ((key = ftok ((dir != NULL) ? dir : ".", 'a')) == -1) {                  /* the key of the launcher */
+        return;
+    }
+    if ((id = semget ((key_t) key, 0, 0)) != -1) {
+        semctl (id, 0, IPC_RMID);
+    }
+    if ((id = shmemConnect (key)) != -1) {
+        shmemDestroy (id);
+    }
+}
+
+/** \brief conversion of a rusage time value to microseconds */
+static long long tvUs (struct timeval tv)
+{
+    return (long long) tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+/** \brief reading the record saved by the launcher */
+static int readRecord (const char *nRec, RUNRESULT *r)
+{
+    char line[RECLEN];
+    long long elapsed, ph[NPHASES];
+    int g, size, p, pos, len;
+    bool hasRun = false;
+    FILE *fp;
+
+    if ((fp = fopen (nRec, "r")) == NULL) {
+        return -1;
+    }
+    r->nSamples = 0;
+    while (fgets (line, RECLEN, fp) != NULL) {
+        if (sscanf (line, "run %d %d %d %lld", &r->nGroups, &r->nServed, &r->nRejected, &elapsed) == 4) {
+            hasRun = true;
+        }
+        else if ((sscanf (line, "group %d %d%n", &g, &size, &pos) == 2) && (r->nSamples < MAXGROUPS)) {
+            for (p = 0; p < NPHASES; p++) {                                   /* one latency per phase follows */
+                if (sscanf (line + pos, "%lld%n", &ph[p], &len) != 1) {
+                    break;
+                }
+                pos += len;
+            }
+            if (p == NPHASES) {
+                for (p = 0; p < NPHASES; p++) {
+                    r->phase[p][r->nSamples] = ph[p];
+                }
+                r->nSamples += 1;
+            }
+        }
+    }
+    fclose (fp);
+    return hasRun ? 0 : -1;
+}
+
+/* external functions */
+
+/**
+ *  \brief Running the simulation once and collecting its measurements.
+ *
+ *  The launcher is executed in directory <tt>dir</tt>, where the entity binaries live, with its standard output
+ *  and error discarded. CPU time and context switches include the launcher and every entity it waited for.
+ *  The semaphore set and the shared region of a run that failed before are removed first, and a run that lasts
+ *  longer than RUNLIMIT seconds is killed, with all its entities, and counts as failed.
+ *
+ *  \param dir directory of the binaries (NULL for the present directory)
+ *  \param config name of the config file
+ *  \param log name of the logging file
+ *  \param seed seed of the random generators of the entities (0 - random)
+ *  \param r pointer to the location where the measurements are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the run failed or its record could not be read
+ */
+int runOnce (const char *dir, const char *config, const char *log, unsigned int seed, RUNRESULT *r)
+{
+    char cfg[PATH_MAX];                                                             /* absolute name of the config file */
+    char nRec[] = "/tmp/restRecordXXXXXX";                                                /* name of the record file */
+    char nSeed[12];                                                                  /* seed of the run, as text */
+    struct rusage ru;
+    struct sigaction sa = { .sa_handler = watchdog }, saOld;                     /* no SA_RESTART: wait4 is cut */
+    long long t0;
+    int fd, pid, status, ret;
+    bool hung = false;
+
+    if (realpath (config, cfg) == NULL) {
+        perror ("error on locating the config file");
+        exit (EXIT_FAILURE);
+    }
+    if ((fd = mkstemp (nRec)) == -1) {
+        perror ("error on creating the record file");
+        exit (EXIT_FAILURE);
+    }
+    close (fd);
+
+    snprintf (nSeed, sizeof (nSeed), "%u", seed);
+    removeStale (dir);
+    sigemptyset (&sa.sa_mask);
+    if (sigaction (SIGALRM, &sa, &saOld) == -1) {
+        perror ("error on installing the watchdog of the run");
+        exit (EXIT_FAILURE);
+    }
+
+    t0 = timeNow ();
+    if ((pid = fork ()) < 0) {
+        perror ("error on the fork operation for the launcher");
+        exit (EXIT_FAILURE);
+    }
+    if (pid == 0) {
+        setpgid (0, 0);                                      /* the launcher and its entities can be killed together */
+        if ((fd = open ("/dev/null", O_WRONLY)) != -1) {
+            dup2 (fd, STDOUT_FILENO);
+            dup2 (fd, STDERR_FILENO);
+            close (fd);
+        }
+        if ((dir != NULL) && (chdir (dir) == -1)) {
+            exit (EXIT_FAILURE);
+        }
+        execl (LAUNCHER, LAUNCHER, "-c", cfg, "-r", nRec, "-s", nSeed, log, NULL);
+        exit (EXIT_FAILURE);
+    }
+    setpgid (pid, pid);                                          /* either may run first: both set the group */
+    alarm (RUNLIMIT);
+    while (wait4 (pid, &status, 0, &ru) == -1) {
+        if (errno != EINTR) {
+            perror ("error on waiting for the launcher");
+            exit (EXIT_FAILURE);
+        }
+        if (!hung) {                                              /* the deadline has passed: the run is hung */
+            hung = true;
+            kill (-pid, SIGKILL);
+        }
+    }
+    alarm (0);
+    sigaction (SIGALRM, &saOld, NULL);
+    if (hung) {
+        fprintf (stderr, "\nrun killed after %d s\n", RUNLIMIT);
+        removeStale (dir);
+    }
+    r->wall = timeNow () - t0;
+    r->cpu = tvUs (ru.ru_utime) + tvUs (ru.ru_stime);
+    r->nvcsw = ru.ru_nvcsw;
+    r->nivcsw = ru.ru_nivcsw;
+
+    ret = (!hung && WIFEXITED (status) && (WEXITSTATUS (status) == EXIT_SUCCESS)) ? readRecord (nRec, r) : -1;
+    unlink (nRec);
+    return ret;
+}
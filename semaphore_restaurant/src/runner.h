@@ -0,0 +1,57 @@
+/**
+ *  \file runner.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Measured execution of a simulation run.
+ *
+ *  Defined operations:
+ *     \li running the simulation once and collecting its measurements.
+ */
+
+#ifndef RUNNER_H_
+#define RUNNER_H_
+
+#include "probConst.h"
+#include "lifecycle.h"
+
+/** \brief longest a run may last (s) before it is taken as hung and killed */
+#ifndef RUNLIMIT
+#define  RUNLIMIT          60
+#endif
+
+/**
+ *  \brief Measurements of a simulation run.
+ */
+typedef struct {
+    long long wall;                                                                      /* elapsed wall time (us) */
+    long long cpu;                                /* user plus system time of the launcher and all its entities (us) */
+    long nvcsw,                                                                      /* voluntary context switches */
+         nivcsw;                                                                   /* involuntary context switches */
+    int nGroups,                                                                               /* number of groups */
+        nServed,                                                                        /* number of groups served */
+        nRejected;                                                                    /* number of groups turned away */
+    int nSamples;                                                       /* number of groups with phase latencies */
+    long long phase[NPHASES][MAXGROUPS];                             /* lifecycle phase latencies of each group (us) */
+} RUNRESULT;
+
+/**
+ *  \brief Running the simulation once and collecting its measurements.
+ *
+ *  The launcher is executed in directory <tt>dir</tt>, where the entity binaries live, with its standard output
+ *  and error discarded. CPU time and context switches include the launcher and every entity it waited for.
+ *  The semaphore set and the shared region of a run that failed before are removed first, and a run that lasts
+ *  longer than RUNLIMIT seconds is killed, with all its entities, and counts as failed.
+ *
+ *  \param dir directory of the binaries (NULL for the present directory)
+ *  \param config name of the config file
+ *  \param log name of the logging file
+ *  \param seed seed of the random generators of the entities (0 - random)
+ *  \param r pointer to the location where the measurements are stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when the run failed or its record could not be read
+ */
+extern int runOnce (const char *dir, const char *config, const char *log, unsigned int seed, RUNRESULT *r);
+
+#endif /* RUNNER_H_ */
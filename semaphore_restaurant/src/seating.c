@@ -0,0 +1,236 @@
+/**
+ *  \file seating.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Assignment of tables to groups.
+ *
+ *  Defined operations:
+ *     \li initialization of the index of free tables
+ *     \li checking if a group can ever be seated under the present policy
+ *     \li seating a group according to the present policy
+ *     \li releasing the tables of a group
+ *     \li name of a seat assignment policy.
+ *
+ *  Free tables are kept in an index by capacity, so best-fit and table joining look up
+ *  at most MAXCAPACITY entries. The operations must be called within the critical region.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+
+/* internal functions */
+
+/** \brief lowest numbered table in a non empty set of tables */
+static int firstTable (unsigned int set)
+{
+    return __builtin_ctz (set);
+}
+
+/** \brief integrates seat usage up to now (must precede any change of the seated people) */
+static void account (FULL_STAT *p_fSt, long long now)
+{
+    long long dt = now - p_fSt->lastSeatChange;
+
+    p_fSt->seatUsage     += dt * p_fSt->seatedPeople;
+    p_fSt->occupiedUsage += dt * p_fSt->occupiedSeats;
+    p_fSt->lastSeatChange = now;
+}
+
+/** \brief binds free table t to group g */
+static void takeTable (FULL_STAT *p_fSt, int t, int g)
+{
+    p_fSt->freeTables[p_fSt->tableCapacity[t]] &= ~(1u << t);
+    p_fSt->tableGroup[t] = g;
+    p_fSt->occupiedSeats += p_fSt->tableCapacity[t];
+}
+
+/** \brief free table with the smallest capacity of at least size seats, or -1 */
+static int bestFit (FULL_STAT *p_fSt, int size)
+{
+    int c;
+
+    for (c = size; c <= MAXCAPACITY; c++) {
+        if (p_fSt->freeTables[c] != 0) {
+            return firstTable (p_fSt->freeTables[c]);
+        }
+    }
+    return -1;
+}
+
+/** \brief lowest numbered free table of at least size seats, or -1 */
+static int firstFit (FULL_STAT *p_fSt, int size)
+{
+    int t;
+
+    for (t = 0; t < NUMTABLES; t++) {
+        if ((p_fSt->tableGroup[t] == -1) && (p_fSt->tableCapacity[t] >= size)) {
+            return t;
+        }
+    }
+    return -1;
+}
+
+/** \brief free table with the largest capacity, or -1 */
+static int largestFree (FULL_STAT *p_fSt)
+{
+    int c;
+
+    for (c = MAXCAPACITY; c > 0; c--) {
+        if (p_fSt->freeTables[c] != 0) {
+            return firstTable (p_fSt->freeTables[c]);
+        }
+    }
+    return -1;
+}
+
+/** \brief number of free seats */
+static int freeSeats (FULL_STAT *p_fSt)
+{
+    int c, n = 0;
+
+    for (c = 1; c <= MAXCAPACITY; c++) {
+        n += c * __builtin_popcount (p_fSt->freeTables[c]);
+    }
+    return n;
+}
+
+/* external functions */
+
+/**
+ *  \brief Initialization of the index of free tables.
+ *
+ *  All tables become free.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+void seatInit (FULL_STAT *p_fSt)
+{
+    int c, t;
+
+    for (c = 0; c <= MAXCAPACITY; c++) {
+        p_fSt->freeTables[c] = 0;
+    }
+    for (t = 0; t < NUMTABLES; t++) {
+        p_fSt->tableGroup[t] = -1;
+        p_fSt->freeTables[p_fSt->tableCapacity[t]] |= 1u << t;
+    }
+    p_fSt->seatedPeople = p_fSt->occupiedSeats = 0;
+    p_fSt->seatUsage = p_fSt->occupiedUsage = 0;
+}
+
+/**
+ *  \brief Checking if a group of the given size can ever be seated under the present policy.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param size number of people of the group
+ *
+ *  \return true if the group fits the restaurant when all tables are free
+ */
+bool seatFeasible (FULL_STAT *p_fSt, int size)
+{
+    int t, largest = 0, total = 0;
+
+    for (t = 0; t < NUMTABLES; t++) {
+        total += p_fSt->tableCapacity[t];
+        if (p_fSt->tableCapacity[t] > largest) {
+            largest = p_fSt->tableCapacity[t];
+        }
+    }
+    if (p_fSt->seatPolicy == TABLEJOIN) {
+        return size <= total;
+    }
+    return size <= largest;
+}
+
+/**
+ *  \brief Seating a group according to the present policy.
+ *
+ *  Tables are taken off the index and bound to the group; seat usage is accounted
+ *  and the time the group sat down is recorded.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param now present time stamp (us)
+ *
+ *  \return table assigned to the group (the lowest numbered one, if tables are joined) or -1 if it must wait
+ */
+int seatAssign (FULL_STAT *p_fSt, int g, long long now)
+{
+    int size = p_fSt->groupSize[g];
+    int t, first = NUMTABLES;
+
+    if (p_fSt->seatPolicy == FIRSTFIT) {
+        t = firstFit (p_fSt, size);
+    }
+    else t = bestFit (p_fSt, size);
+    if ((t == -1) && ((p_fSt->seatPolicy != TABLEJOIN) || (freeSeats (p_fSt) < size))) {
+        return -1;
+    }
+
+    account (p_fSt, now);
+    /* largest free tables are joined until the rest of the group fits a single table */
+    while (t == -1) {
+        t = largestFree (p_fSt);
+        size -= p_fSt->tableCapacity[t];
+        takeTable (p_fSt, t, g);
+        if (t < first) first = t;
+        t = bestFit (p_fSt, size);
+    }
+    takeTable (p_fSt, t, g);
+    if (t < first) first = t;
+
+    p_fSt->seatedPeople += p_fSt->groupSize[g];
+    setGroupTable (p_fSt, g, first);
+    setGroupTime (p_fSt, g, T_SEATED, now);
+    return first;
+}
+
+/**
+ *  \brief Releasing the tables of a group.
+ *
+ *  Tables are put back into the index and seat usage is accounted.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param now present time stamp (us)
+ *
+ *  \return table that was assigned to the group
+ */
+int seatRelease (FULL_STAT *p_fSt, int g, long long now)
+{
+    int t, table = groupTable (p_fSt, g);
+
+    account (p_fSt, now);
+    for (t = 0; t < NUMTABLES; t++) {
+        if (p_fSt->tableGroup[t] == g) {
+            p_fSt->tableGroup[t] = -1;
+            p_fSt->freeTables[p_fSt->tableCapacity[t]] |= 1u << t;
+            p_fSt->occupiedSeats -= p_fSt->tableCapacity[t];
+        }
+    }
+    p_fSt->seatedPeople -= p_fSt->groupSize[g];
+    setGroupTable (p_fSt, g, -1);
+    return table;
+}
+
+/**
+ *  \brief Name of a seat assignment policy.
+ *
+ *  \param policy policy id
+ *
+ *  \return printable name of the policy
+ */
+const char *seatPolicyName (int policy)
+{
+    switch (policy) {
+        case FIRSTFIT:  return "first-fit";
+        case BESTFIT:   return "best-fit";
+        case TABLEJOIN: return "table joining";
+    }
+    return "unknown";
+}
@@ -0,0 +1,81 @@
+/**
+ *  \file seating.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Assignment of tables to groups.
+ *
+ *  Defined operations:
+ *     \li initialization of the index of free tables
+ *     \li checking if a group can ever be seated under the present policy
+ *     \li seating a group according to the present policy
+ *     \li releasing the tables of a group
+ *     \li name of a seat assignment policy.
+ *
+ *  Free tables are kept in an index by capacity, so best-fit and table joining look up
+ *  at most MAXCAPACITY entries. The operations must be called within the critical region.
+ */
+
+#ifndef SEATING_H_
+#define SEATING_H_
+
+#include <stdbool.h>
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Initialization of the index of free tables.
+ *
+ *  All tables become free.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+extern void seatInit (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Checking if a group of the given size can ever be seated under the present policy.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param size number of people of the group
+ *
+ *  \return true if the group fits the restaurant when all tables are free
+ */
+extern bool seatFeasible (FULL_STAT *p_fSt, int size);
+
+/**
+ *  \brief Seating a group according to the present policy.
+ *
+ *  Tables are taken off the index and bound to the group; seat usage is accounted
+ *  and the time the group sat down is recorded.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param now present time stamp (us)
+ *
+ *  \return table assigned to the group (the lowest numbered one, if tables are joined) or -1 if it must wait
+ */
+extern int seatAssign (FULL_STAT *p_fSt, int g, long long now);
+
+/**
+ *  \brief Releasing the tables of a group.
+ *
+ *  Tables are put back into the index and seat usage is accounted.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param g group id
+ *  \param now present time stamp (us)
+ *
+ *  \return table that was assigned to the group
+ */
+extern int seatRelease (FULL_STAT *p_fSt, int g, long long now);
+
+/**
+ *  \brief Name of a seat assignment policy.
+ *
+ *  \param policy policy id
+ *
+ *  \return printable name of the policy
+ */
+extern const char *seatPolicyName (int policy);
+
+#endif /* SEATING_H_ */
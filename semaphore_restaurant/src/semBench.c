@@ -0,0 +1,417 @@
+/**
+ *  \file semBench.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  Micro-benchmarks of the semaphore primitives used by the intervening entities.
+ *
+ *  Measured operations:
+ *     \li <em>up</em> and <em>down</em> of an uncontended semaphore
+ *     \li round trip of a two process ping-pong over a pair of semaphores
+ *     \li acquisition of a mutex shared by several processes
+ *     \li connection to an existing semaphore set (start up cost of every entity).
+ *
+ *  Every sample is a latency in nanoseconds. For each benchmark the mean, minimum, maximum and
+ *  percentiles 50, 90, 99 and 99.9 are printed in CSV on the standard output and saved both as
+ *  <tt>basename.csv</tt> and <tt>basename.json</tt>, tagged with the semaphore backend and the kernel
+ *  release, so that results of different machines and kernels can be compared.
+ *
+ *  Usage: semBench [-n iterations] [-p processes] [-o basename]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/types.h>
+#include <sys/ipc.h>
+#include <sys/utsname.h>
+#include <string.h>
+
+#include "semaphore.h"
+#include "sharedMemory.h"
+#include "timing.h"
+#include "stats.h"
+
+/** \brief semaphore backend being measured */
+#define  BACKEND        "sysv"
+
+/** \brief default number of samples per benchmark (and per process, in the contention benchmark) */
+#define  DEFITER        100000
+
+/** \brief default number of processes competing for the mutex */
+#define  DEFPROC        4
+
+/** \brief maximum number of processes competing for the mutex */
+#define  MAXPROC        64
+
+/** \brief number of benchmarks */
+#define  NBENCH         5
+
+/** \brief semaphore used in the uncontended and contention benchmarks */
+#define  BMUTEX         1
+
+/** \brief semaphore signalled by the ping-pong initiator */
+#define  BPING          2
+
+/** \brief semaphore signalled by the ping-pong responder */
+#define  BPONG          3
+
+/** \brief semaphore used to start the competing processes together */
+#define  BSTART         4
+
+/** \brief number of semaphores in the benchmark set */
+#define  BSEM_NU        4
+
+/** \brief summary of the samples of a benchmark */
+typedef struct {
+    const char *name;                                                                            /* benchmark name */
+    int n;                                                                                    /* number of samples */
+    double mean, min, max, p50, p90, p99, p999;                                                   /* statistics (ns) */
+} BENCH;
+
+/** \brief number of samples per benchmark */
+static int nIter = DEFITER;
+
+/** \brief number of processes competing for the mutex */
+static int nProc = DEFPROC;
+
+/** \brief semaphore set access identifier */
+static int semgid = -1;
+
+/** \brief access key to the semaphore set */
+static int semKey;
+
+/** \brief results of all benchmarks */
+static BENCH bench[NBENCH];
+
+/** \brief number of benchmarks already run */
+static int nBench = 0;
+
+static void fail (const char *msg);
+static void summarize (const char *name, double v[], int n);
+static void benchUncontended (double *v);
+static void benchPingPong (double *v);
+static void benchContention (void);
+static void benchConnect (double *v);
+static void writeCsv (FILE *fp);
+static void writeJson (FILE *fp);
+
+/**
+ *  \brief Main program.
+ *
+ *  Its role is to create the semaphore set, run every benchmark and report the results.
+ */
+int main (int argc, char *argv[])
+{
+    char base[256] = "semBench";                                                    /* base name of result files */
+    char name[300];
+    double *v;
+    FILE *fp;
+    int opt;
+
+    while ((opt = getopt (argc, argv, "n:p:o:")) != -1) {
+        switch (opt) {
+            case 'n': nIter = atoi (optarg);
+                      break;
+            case 'p': nProc = atoi (optarg);
+                      break;
+            case 'o': snprintf (base, sizeof (base), "%s", optarg);
+                      break;
+            default:  fprintf (stderr, "Usage: %s [-n iterations] [-p processes] [-o basename]\n", argv[0]);
+                      exit (EXIT_FAILURE);
+        }
+    }
+    if ((nIter < 1) || (nProc < 2) || (nProc > MAXPROC)) {
+        fprintf (stderr, "iterations must be positive and processes in 2 .. %d\n", MAXPROC);
+        exit (EXIT_FAILURE);
+    }
+
+    if ((semKey = ftok (".", 'b')) == -1) {
+        fail ("error on generating the key");
+    }
+    if ((semgid = semCreate (semKey, BSEM_NU)) == -1) {
+        fail ("error on creating the semaphore set");
+    }
+    if (semSignal (semgid) == -1) {
+        fail ("error on signaling start of operations");
+    }
+    if ((v = malloc (2 * (size_t) nIter * sizeof (double))) == NULL) {
+        fail ("error on allocating the sample buffer");
+    }
+
+    benchUncontended (v);
+    benchPingPong (v);
+    benchContention ();
+    benchConnect (v);
+    free (v);
+
+    if (semDestroy (semgid) == -1) {
+        fail ("error on destructing the semaphore set");
+    }
+
+    writeCsv (stdout);
+    snprintf (name, sizeof (name), "%s.csv", base);
+    if ((fp = fopen (name, "w")) == NULL) {
+        fail ("error on creating the CSV file");
+    }
+    writeCsv (fp);
+    fclose (fp);
+    snprintf (name, sizeof (name), "%s.json", base);
+    if ((fp = fopen (name, "w")) == NULL) {
+        fail ("error on creating the JSON file");
+    }
+    writeJson (fp);
+    fclose (fp);
+
+    return EXIT_SUCCESS;
+}
+
+/**
+ *  \brief Reporting an error and terminating.
+ *
+ *  The semaphore set is removed, if it was already created.
+ *
+ *  \param msg error message
+ */
+static void fail (const char *msg)
+{
+    perror (msg);
+    if (semgid != -1) {
+        semDestroy (semgid);
+    }
+    exit (EXIT_FAILURE);
+}
+
+/**
+ *  \brief Computing the statistics of a benchmark.
+ *
+ *  The samples are sorted in place.
+ *
+ *  \param name benchmark name
+ *  \param v samples (ns)
+ *  \param n number of samples
+ */
+static void summarize (const char *name, double v[], int n)
+{
+    BENCH *b = &bench[nBench++];
+
+    b->name = name;
+    b->n = n;
+    b->mean = statMean (v, n);
+    b->p50  = statPercentile (v, n, 50.0);
+    b->p90  = statPercentile (v, n, 90.0);
+    b->p99  = statPercentile (v, n, 99.0);
+    b->p999 = statPercentile (v, n, 99.9);
+    b->min  = v[0];
+    b->max  = v[n-1];
+}
+
+/**
+ *  \brief Uncontended <em>up</em> and <em>down</em>.
+ *
+ *  A single process alternates <em>up</em> and <em>down</em> on the same semaphore, which never blocks.
+ *
+ *  \param v sample buffer (2 * nIter values)
+ */
+static void benchUncontended (double *v)
+{
+    long long t0, t1, t2;
+    int i;
+
+    for (i = 0; i < nIter; i++) {
+        t0 = timeNowNs ();
+        if (semUp (semgid, BMUTEX) == -1) {
+            fail ("error on the up operation for semaphore access");
+        }
+        t1 = timeNowNs ();
+        if (semDown (semgid, BMUTEX) == -1) {
+            fail ("error on the down operation for semaphore access");
+        }
+        t2 = timeNowNs ();
+        v[i] = (double) (t1 - t0);
+        v[nIter+i] = (double) (t2 - t1);
+    }
+    summarize ("uncontended_up", v, nIter);
+    summarize ("uncontended_down", v + nIter, nIter);
+}
+
+/**
+ *  \brief Two process ping-pong.
+ *
+ *  The responder waits on one semaphore and signals the other; each sample is a full round trip,
+ *  so it includes two wake ups and two context switches.
+ *
+ *  \param v sample buffer (nIter values)
+ */
+static void benchPingPong (double *v)
+{
+    long long t0;
+    int pid, status, i;
+
+    if ((pid = fork ()) < 0) {
+        fail ("error on the fork operation for the responder");
+    }
+    if (pid == 0) {
+        for (i = 0; i < nIter; i++) {
+            if ((semDown (semgid, BPING) == -1) || (semUp (semgid, BPONG) == -1)) {
+                perror ("error on the responder semaphore operations");
+                exit (EXIT_FAILURE);
+            }
+        }
+        exit (EXIT_SUCCESS);
+    }
+    for (i = 0; i < nIter; i++) {
+        t0 = timeNowNs ();
+        if (semUp (semgid, BPING) == -1) {
+            fail ("error on the up operation for semaphore access");
+        }
+        if (semDown (semgid, BPONG) == -1) {
+            fail ("error on the down operation for semaphore access");
+        }
+        v[i] = (double) (timeNowNs () - t0);
+    }
+    if ((waitpid (pid, &status, 0) == -1) || !WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+        fail ("error on the responder process");
+    }
+    summarize ("pingpong_rtt", v, nIter);
+}
+
+/**
+ *  \brief Mutex contention.
+ *
+ *  nProc processes repeatedly acquire and release the same mutex; each sample is the time spent
+ *  in <em>down</em>. The samples are collected in a shared memory region.
+ */
+static void benchContention (void)
+{
+    int key, shmid, pid[MAXPROC], status, p, i;
+    long long t0, t1;
+    double *v;
+
+    if ((key = ftok (".", 'c')) == -1) {
+        fail ("error on generating the key");
+    }
+    if ((shmid = shmemCreate (key, (unsigned int) nProc * nIter * sizeof (double))) == -1) {
+        fail ("error on creating the shared memory region");
+    }
+    if (shmemAttach (shmid, (void **) &v) == -1) {
+        shmemDestroy (shmid);
+        fail ("error on mapping the shared region on the process address space");
+    }
+    if (semUp (semgid, BMUTEX) == -1) {                                              /* the mutex starts green */
+        fail ("error on the up operation for semaphore access");
+    }
+
+    for (p = 0; p < nProc; p++) {
+        if ((pid[p] = fork ()) < 0) {
+            fail ("error on the fork operation for a competing process");
+        }
+        if (pid[p] == 0) {
+            if (semDown (semgid, BSTART) == -1) {
+                perror ("error on the down operation for semaphore access");
+                exit (EXIT_FAILURE);
+            }
+            for (i = 0; i < nIter; i++) {
+                t0 = timeNowNs ();
+                if (semDown (semgid, BMUTEX) == -1) {
+                    perror ("error on the down operation for semaphore access");
+                    exit (EXIT_FAILURE);
+                }
+                t1 = timeNowNs ();
+                if (semUp (semgid, BMUTEX) == -1) {
+                    perror ("error on the up operation for semaphore access");
+                    exit (EXIT_FAILURE);
+                }
+                v[p*nIter+i] = (double) (t1 - t0);
+            }
+            exit (EXIT_SUCCESS);
+        }
+    }
+    for (p = 0; p < nProc; p++) {                                          /* all processes start together */
+        if (semUp (semgid, BSTART) == -1) {
+            fail ("error on the up operation for semaphore access");
+        }
+    }
+    for (p = 0; p < nProc; p++) {
+        if ((waitpid (pid[p], &status, 0) == -1) || !WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+            fail ("error on a competing process");
+        }
+    }
+    if (semDown (semgid, BMUTEX) == -1) {
+        fail ("error on the down operation for semaphore access");
+    }
+
+    summarize ("contended_down", v, nProc * nIter);
+
+    if (shmemDettach (v) == -1) {
+        fail ("error on unmapping the shared region off the process address space");
+    }
+    if (shmemDestroy (shmid) == -1) {
+        fail ("error on destructing the shared region");
+    }
+}
+
+/**
+ *  \brief Connection to an existing semaphore set.
+ *
+ *  Every intervening entity pays this cost once, when it starts.
+ *
+ *  \param v sample buffer (nIter values)
+ */
+static void benchConnect (double *v)
+{
+    long long t0;
+    int i;
+
+    for (i = 0; i < nIter; i++) {
+        t0 = timeNowNs ();
+        if (semConnect (semKey) == -1) {
+            fail ("error on connecting to the semaphore set");
+        }
+        v[i] = (double) (timeNowNs () - t0);
+    }
+    summarize ("connect", v, nIter);
+}
+
+/**
+ *  \brief Writing the results in CSV.
+ *
+ *  \param fp output stream
+ */
+static void writeCsv (FILE *fp)
+{
+    int b;
+
+    fprintf (fp, "benchmark,samples,mean_ns,min_ns,p50_ns,p90_ns,p99_ns,p999_ns,max_ns\n");
+    for (b = 0; b < nBench; b++) {
+        fprintf (fp, "%s,%d,%.1f,%.0f,%.1f,%.1f,%.1f,%.1f,%.0f\n", bench[b].name, bench[b].n, bench[b].mean,
+                 bench[b].min, bench[b].p50, bench[b].p90, bench[b].p99, bench[b].p999, bench[b].max);
+    }
+}
+
+/**
+ *  \brief Writing the results in JSON.
+ *
+ *  \param fp output stream
+ */
+static void writeJson (FILE *fp)
+{
+    struct utsname un;
+    int b;
+
+    if (uname (&un) == -1) {
+        strcpy (un.release, "unknown");
+        strcpy (un.machine, "unknown");
+    }
+    fprintf (fp, "{\n  \"backend\": \"%s\",\n  \"kernel\": \"%s\",\n  \"machine\": \"%s\",\n"
+                 "  \"iterations\": %d,\n  \"processes\": %d,\n  \"benchmarks\": [\n",
+             BACKEND, un.release, un.machine, nIter, nProc);
+    for (b = 0; b < nBench; b++) {
+        fprintf (fp, "    {\"name\": \"%s\", \"samples\": %d, \"mean_ns\": %.1f, \"min_ns\": %.0f, \"p50_ns\": %.1f, "
+                     "\"p90_ns\": %.1f, \"p99_ns\": %.1f, \"p999_ns\": %.1f, \"max_ns\": %.0f}%s\n",
+                 bench[b].name, bench[b].n, bench[b].mean, bench[b].min, bench[b].p50, bench[b].p90,
+                 bench[b].p99, bench[b].p999, bench[b].max, (b < nBench - 1) ? "," : "");
+    }
+    fprintf (fp, "  ]\n}\n");
+}
@@ -10,6 +10,10 @@
  *     \li waitOrder
  *     \li processOrder
  *
+ *  The kitchen is a pipeline of stations (prep, cook, plate, see kitchen.h); the chef process generates the
+ *  workers of every station, each one a process of its own running the life cycle above on its station, and
+ *  waits for them.
+ *
  *  \author Nuno Lau - December 2023
  */
 
@@ -23,6 +27,7 @@
 #include <signal.h>
 #include <sys/time.h>
 #include <errno.h>
+#include <sys/wait.h>
 
 #include "probConst.h"
 #include "probDataStruct.h"
@@ -30,6 +35,12 @@
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "timing.h"
+#include "kitchen.h"
+#include "slab.h"
+#include "shelf.h"
+#include "trace.h"
+#include "probes.h"
 
 
 /** \brief logging file name */
@@ -41,13 +52,28 @@ static int shmid;
 /** \brief semaphore set access identifier */
 static int semgid;
 
-/** \brief group that requested cooking food */
-static int lastGroup;
+/** \brief station of this worker (ST_PREP .. ST_PLATE) */
+static int station;
+
+/** \brief orders being worked on together */
+static ORDER batch[MAXBATCH];
+
+/** \brief number of orders being worked on together */
+static int batchSize;
+
+/** \brief number of portions of each dish of the batch taken off the prep-ahead shelf */
+static int shelved[MAXDISHES];
+
+/** \brief cooking time (us) of the batch avoided thanks to the prep-ahead shelf */
+static long long saved;
 
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
-static void waitForOrder ();
+static void worker (int s, int k);
+static bool waitForOrder ();
+static bool preCook ();
+static void passOn (int portions[], long long busy);
 static void processOrder ();
 
 /**
@@ -93,20 +119,36 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    /* initialize random generator */
-    srandom ((unsigned int) getpid ());                                      
-
-    /* simulation of the life cycle of the chef -> Indica o que o Chef vai fazer */
+    /* generation of the workers of the stations of the kitchen -> Cada posto da cozinha tem os seus trabalhadores */
+    int k = 0, status, failed = 0;
+    for (int s = 0; s < NSTATIONS; s++) {
+        for (int w = 0; w < sh->fSt.station[s].workers; w++, k++) {
+            pid_t pid = fork ();
+            if (pid < 0) {
+                perror ("error on the fork operation for a kitchen worker");
+                exit (EXIT_FAILURE);
+            }
+            if (pid == 0) {
+                worker (s, k);
+            }
+            /* O launcher soma a memória de cada trabalhador à do pessoal, no modo contínuo */
+            __atomic_store_n (&sh->fSt.station[s].pid[w], (int) pid, __ATOMIC_RELAXED);
+        }
+    }
 
-    int nOrders = 0;
-    /* Enquanto o nº de pedidos de comida (Group Orders) for inferior ao máximo de orders possível para o Chef, executa este loop */
-    while (nOrders < sh->fSt.nGroups) {     // O Chef apenas responde aos nGroups, com as nOrders que eles fazem ao Waiter, e que este lhe reencaminha
-       /* Espera por uma order de um grupo, para poder cozinhar */
-       waitForOrder();
-       /* Processa a order recebida acima, isto é, cozinha e entrega o pedido ao Waiter para este levar à mesa respetiva */
-       processOrder();
-       /* Incrementa o nº de pedidos */
-       nOrders++;
+    /* waiting for the termination of the workers (their resource usage is added to that of the chef) */
+    pid_t pid;
+    while ((pid = wait (&status)) != -1) {
+        if (!WIFEXITED (status) || (WEXITSTATUS (status) != EXIT_SUCCESS)) {
+            failed++;
+        }
+        for (int s = 0; s < NSTATIONS; s++) {
+            for (int w = 0; w < sh->fSt.station[s].workers; w++) {
+                if (__atomic_load_n (&sh->fSt.station[s].pid[w], __ATOMIC_RELAXED) == (int) pid) {
+                    __atomic_store_n (&sh->fSt.station[s].pid[w], 0, __ATOMIC_RELAXED);
+                }
+            }
+        }
     }
 
     /* unmapping the shared region off the process address space */
@@ -116,46 +158,167 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;;
     }
 
-    return EXIT_SUCCESS;
+    return (failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ *  \brief life cycle of a worker of a station of the kitchen
+ *
+ *  Runs in a process of its own, generated by the chef, until all the orders have gone through the station.
+ *
+ *  \param s station
+ *  \param k worker number (over all stations; 0 is the first prep worker)
+ */
+static void worker (int s, int k)
+{
+    station = s;
+
+    /* initialize random generator (reproducible if the run is seeded; the first worker keeps the stream of the chef) */
+    srandom ((sh->fSt.seed != 0) ? (sh->fSt.seed + U_CHEF) * (k + 1) : (unsigned int) getpid ());
+
+    /* opening the trace track of the worker (only if tracing is enabled) */
+    traceOpen (TR_CHEF, k, WAIT_FOR_ORDER);
+
+    /* simulation of the life cycle of the worker -> Indica o que cada trabalhador do posto vai fazer */
+
+    /* Enquanto houver pedidos por passar pelo posto (os nServed grupos fazem um pedido cada), executa este loop */
+    while (waitForOrder()) {
+       /* Trata os pedidos recebidos acima e passa-os ao posto seguinte (ou ao Waiter, no último posto) */
+       processOrder();
+    }
+
+    traceClose ();
+
+    /* Soma o nº de operações sobre semáforos ao registo do Chef (os trabalhadores terminam em qualquer ordem) */
+    __atomic_fetch_add (&sh->fSt.usage[U_CHEF].semOps, semOpCount (), __ATOMIC_RELAXED);
+
+    if (shmemDettach (sh) == -1) { 
+        perror ("error on unmapping the shared region off the process address space");
+        exit (EXIT_FAILURE);
+    }
+    exit (EXIT_SUCCESS);
 }
 
 /**
  *  \brief chefs wait for a food order.
  *
- *  The chef waits for the food request that will be provided by the waiter. 
- *  Updates its state and saves internal state. 
- *  Received order should be acknowledged. 
+ *  The worker waits for an order in the queue of its station and takes it
+ *  (the first station takes the next order out of the kitchen order queue: oldest
+ *  under FIFO, earliest deadline under EDF; the others take them in arrival order).
+ *  In batching mode, a cook waits the batching window and then also takes the
+ *  pending orders, up to the batch size, without blocking.
+ *  With the prep-ahead shelf, an idle cook pre-cooks popular dishes while no order
+ *  arrives (see preCook), and the portions of the orders found on the shelf are taken off it.
+ *  Updates its state and saves internal state (cook station). 
+ *  The slots of the received orders are given back to the previous station (the waiter,
+ *  for the first station). 
+ *  When all the orders have gone through the station, the worker wakes the next idle
+ *  worker of the station and terminates (in the continuous mode, only after closing;
+ *  the launcher wakes a worker of every station once all groups are gone).
+ *
+ *  \return true if orders were taken, false if there are no more orders for the station
  */
-static void waitForOrder ()
+static bool waitForOrder ()
 {
-    /* O Chef começa sempre por aguardar um pedido (vindo do Waiter, que reencaminha do Grupo) */
-    if (semDown(semgid, sh->waitOrder) == -1) {                                                    
+    PROBE0 (waitForOrder__entry);
+
+    STATION *st = &sh->fSt.station[station];
+    int taken, wake = 0;
+    bool got = false;
+
+    /* 
+        Com a prateleira de pré-preparação, o cozinheiro espera um pedido só durante algum tempo; se não 
+        chegar nenhum, aproveita para pré-cozinhar um dos pratos mais pedidos e volta a esperar 
+    */
+    if ((station == ST_COOK) && (sh->fSt.shelf.capacity > 0)) {
+        while (!(got = (semTimedDown(semgid, sh->stationOrder[station], sh->fSt.shelf.idle) == 0))) {
+            if (errno != EAGAIN) {
+                perror ("error on the down operation for semaphore access (PT)");
+                exit (EXIT_FAILURE);
+            }
+            if (!preCook()) {
+                break;
+            }
+        }
+    }
+
+    /* O trabalhador começa sempre por aguardar um pedido na fila do seu posto (no primeiro, a fila da cozinha, vinda do Waiter) */
+    if (!got && (semDown(semgid, sh->stationOrder[station]) == -1)) {                                                    
         perror ("error on the up operation for semaphore access (PT)");
         exit (EXIT_FAILURE);
     }
+    batchSize = 1;
 
     /* 
-        O Chef recebe o pedido assim que puder dar semDown do semáforo anterior (isto é, assim que Waiter 
-        dá semUp a informar que existe um novo pedido), logo nesta linha já o recebeu* 
+        Em modo de lotes, o cozinheiro espera a janela de agrupamento para deixar chegar mais pedidos e 
+        depois junta os que estiverem na fila (sem bloquear), até ao tamanho máximo do lote 
     */
+    if ((station == ST_COOK) && (sh->fSt.maxBatch > 1)) {
+        if (sh->fSt.batchWindow > 0) {
+            usleep((unsigned int) sh->fSt.batchWindow);
+        }
+        while (batchSize < sh->fSt.maxBatch) {
+            if (semTryDown(semgid, sh->stationOrder[station]) == -1) {
+                if (errno == EAGAIN) {
+                    break;
+                }
+                perror ("error on the down operation for semaphore access (PT)");
+                exit (EXIT_FAILURE);
+            }
+            batchSize++;
+        }
+    }
 
     // ------------------------------ [Região crítica] ------------------------------ //
     if (semDown (semgid, sh->mutex) == -1) {                 /* enter critical region */
         perror ("error on the up operation for semaphore access (PT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* 
-        Aqui, a partir da informação que recebe do Waiter, o Chef atualiza o lastGroup para o grupo que vem no pedido. 
-        Esta variável será sempre precisa para que depois o Waiter consiga levar o pedido à mesa certa.
+        Aqui, o trabalhador retira os pedidos seguintes da fila e guarda-os em 'batch' (o grupo e o conteúdo 
+        de cada pedido). Depois de passarem todos os pedidos pelo posto, as unidades que sobrarem no semáforo 
+        servem apenas para acordar os outros trabalhadores do posto, para que terminem.
     */
-    lastGroup = sh->fSt.foodGroup; // 'sh->fSt.foodGroup' tem o grupo associado ao pedido que o Chef recebeu
-    /* Sendo que já recebeu um novo pedido, então atualiza o seu estado para "a cozinhar" */
-    sh->fSt.st.chefStat = COOK;
+    taken = (batchSize < sh->fSt.nServed - st->taken) ? batchSize : sh->fSt.nServed - st->taken;
+    for (int i = 0; i < taken; i++) {
+        batch[i] = stationPop(&sh->fSt, station, timeNow());
+    }
+    wake = batchSize - taken + (((taken > 0) && sh->fSt.closing && (st->taken == sh->fSt.nServed)) ? 1 : 0);
+
+    /* As doses que já estiverem na prateleira (frescas) são servidas logo, sem as cozinhar */
+    if ((station == ST_COOK) && (sh->fSt.shelf.capacity > 0)) {
+        for (int d = 0; d < sh->fSt.nDishes; d++) {
+            shelved[d] = 0;
+        }
+        for (int i = 0; i < taken; i++) {
+            ORDERPAYLOAD *order = slabPtr (&sh->fSt.slab, batch[i].payload);
+            bool whole = true;
+            for (int k = 0; k < order->nItems; k++) {
+                int n = shelfTake(&sh->fSt, order->item[k].dish, order->item[k].quantity, timeNow());
+                shelved[order->item[k].dish] += n;
+                whole = whole && (n == order->item[k].quantity);
+            }
+            if (whole) {
+                sh->fSt.shelf.nOrderHits++;
+            }
+        }
+    }
+    batchSize = taken;
+    if (batchSize > 0) {
+        /* Sendo que já recebeu um novo pedido, então atualiza o seu estado para "a cozinhar" */
+        traceState (COOK);
+        if (station == ST_COOK) {
+            sh->fSt.nBatches++;
+            sh->fSt.st.chefStat = COOK;
     
-    /* Salva-se o estado interno */
-    saveState(nFic, &sh->fSt);
+            /* Salva-se o estado interno */
+            saveState(nFic, &sh->fSt);
+        }
+    }
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
         perror ("error on the up operation for semaphore access (PT)");
         exit (EXIT_FAILURE);
@@ -163,31 +326,309 @@ static void waitForOrder ()
     // ------------------------------------------------------------------------------ //
 
     /* 
-        Aqui, o Chef notifica o Waiter de que recebeu corretamente o pedido, 
-        para que o Waiter possa ir atender outros pedidos 
+        Aqui, o trabalhador liberta os lugares dos pedidos na fila, para que o posto anterior (ou o Waiter) 
+        lá possa colocar outros pedidos; e acorda o trabalhador seguinte do posto, se já não houver pedidos 
     */
-    if (semUp(semgid, sh->orderReceived) == -1) {                                                    
+    for (int i = 0; i < batchSize; i++) {
+        if (semUp(semgid, sh->stationSlot[station]) == -1) {                                                    
+            perror ("error on the up operation for semaphore access (PT)");
+            exit (EXIT_FAILURE);
+        }     
+    }
+    for (int i = 0; i < wake; i++) {
+        if (semUp(semgid, sh->stationOrder[station]) == -1) {                                                    
+            perror ("error on the up operation for semaphore access (PT)");
+            exit (EXIT_FAILURE);
+        }     
+    }
+    PROBE1 (waitForOrder__return, batchSize);
+    return batchSize > 0;
+}
+
+/**
+ *  \brief normal distribution generator with zero mean and stddev deviation. 
+ *
+ *  Generates random number according to normal distribution.
+ * 
+ *  \param stddev controls standard deviation of distribution
+ */
+static double normalRand(double stddev)
+{
+   int i;
+
+   double r=0.0;
+   for (i=0;i<12;i++) {
+       r += random()/(RAND_MAX+1.0);
+   }
+   r -= 6.0;
+
+   return r*stddev;
+}
+
+/**
+ *  \brief idle cook pre-cooks a popular dish for the prep-ahead shelf
+ *
+ *  The dish and the number of portions are chosen by the popularity model (see shelf.h);
+ *  the cook takes a time drawn from the distribution of the dish and puts the portions on
+ *  the shelf.
+ *
+ *  \return true if something was pre-cooked, false if the shelf is stocked as predicted
+ *          or there are no more orders to come
+ */
+static bool preCook ()
+{
+    int dish = -1, n = 0;
+
+    // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1) {                                  /* enter critical region */
         perror ("error on the up operation for semaphore access (PT)");
         exit (EXIT_FAILURE);
-    }     
+    }
+    seqBegin (sh);
+
+    /* O cozinheiro escolhe o prato em falta na prateleira (só enquanto houver pedidos por chegar) */
+    if (!sh->fSt.closing || (sh->fSt.station[ST_COOK].taken < sh->fSt.nServed)) {
+        dish = shelfPlan(&sh->fSt, timeNow(), &n);
+    }
+    if (dish != -1) {
+        traceState (COOK);
+    }
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                                      /* exit critical region */
+        perror ("error on the up operation for semaphore access (PT)");
+        exit (EXIT_FAILURE);
+    }
+    // ------------------------------------------------------------------------------ //
+
+    if (dish == -1) {
+        return false;
+    }
+
+    /* O cozinheiro pré-cozinha as doses do prato, demorando o tempo de preparação do prato */
+    long long start = timeNow();
+    double prep = sh->fSt.dishMean[dish] + normalRand (sh->fSt.dishDev[dish]);
+    if (prep >= 1.0) {
+        usleep((unsigned int) prep);
+    }
+
+    // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1) {                                  /* enter critical region */
+        perror ("error on the up operation for semaphore access (PT)");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+
+    /* As doses ficam na prateleira até serem pedidas ou se estragarem */
+    long long now = timeNow();
+    shelfStock(&sh->fSt, dish, n, now);
+    sh->fSt.shelf.busy += now - start;
+    sh->fSt.station[ST_COOK].busy += now - start;
+    traceState (WAIT_FOR_ORDER);
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                                      /* exit critical region */
+        perror ("error on the up operation for semaphore access (PT)");
+        exit (EXIT_FAILURE);
+    }
+    // ------------------------------------------------------------------------------ //
+
+    return true;
+}
+
+/**
+ *  \brief working time of the batch at the station of the worker, a function of the contents of its orders
+ *
+ *  The orders are read in place from their payloads. At the cook station every dish of the menu that appears
+ *  in the batch is prepared once, for all its portions, taking a time drawn from its distribution, and each
+ *  order besides the first adds the marginal time of the batch; the other stations take their time per portion.
+ *  A dish whose portions were all taken off the prep-ahead shelf is not prepared, and its time counts as saved.
+ *
+ *  \param portions number of portions of each dish in the batch (filled in)
+ *
+ *  \return working time (us)
+ */
+static long long workTime (int portions[])
+{
+    long long t = 0;
+    double prep;
+    int i, k, d, n = 0;
+
+    for (d = 0; d < sh->fSt.nDishes; d++) {
+        portions[d] = 0;
+    }
+    for (i = 0; i < batchSize; i++) {
+        ORDERPAYLOAD *order = slabPtr (&sh->fSt.slab, batch[i].payload);
+        for (k = 0; k < order->nItems; k++) {
+            portions[order->item[k].dish] += order->item[k].quantity;
+            n += order->item[k].quantity;
+        }
+    }
+    if (station != ST_COOK) {
+        return n * (long long) sh->fSt.station[station].perPortion;
+    }
+    saved = 0;
+    for (d = 0; d < sh->fSt.nDishes; d++) {
+        if (portions[d] > 0) {
+            prep = sh->fSt.dishMean[d] + normalRand (sh->fSt.dishDev[d]);
+            if (portions[d] > shelved[d]) {
+                t += (prep > 0.0) ? (long long) prep : 0;
+            }
+            else saved += (prep > 0.0) ? (long long) prep : 0;
+        }
+    }
+    if (t > 0) {
+        t += (batchSize - 1) * (long long) sh->fSt.cookPerDish;
+    }
+    else saved += (batchSize - 1) * (long long) sh->fSt.cookPerDish;
+    return t;
+}
+
+/**
+ *  \brief worker passes the batch on to the next station
+ *
+ *  Waits for room in the queue of the next station for every order of the batch
+ *  (back-pressure), then queues them and tells the workers of the next station.
+ *  At the cook station the state of the chef and the portions cooked are updated
+ *  and the internal state is saved.
+ *
+ *  \param portions number of portions of each dish in the batch
+ *  \param busy working time (us) of the batch
+ */
+static void passOn (int portions[], long long busy)
+{
+    int next = station + 1;
+
+    /* O trabalhador espera que haja lugar para cada pedido na fila do posto seguinte */
+    long long blockStart = timeNow();
+    for (int i = 0; i < batchSize; i++) {
+        if (semDown(semgid, sh->stationSlot[next]) == -1) {                                                    
+            perror ("error on the down operation for semaphore access (PT)");
+            exit (EXIT_FAILURE);
+        }
+    }
+    long long blocked = timeNow() - blockStart;
+
+    // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1) {                                  /* enter critical region */
+        perror ("error on the up operation for semaphore access (PT)");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+
+    /* Os pedidos do lote passam para a fila do posto seguinte */
+    long long now = timeNow();
+    for (int i = 0; i < batchSize; i++) {
+        stationPush(&sh->fSt, next, batch[i], now);
+    }
+    sh->fSt.station[station].busy += busy;
+    sh->fSt.station[station].blocked += blocked;
+    traceState (WAIT_FOR_ORDER);
+    if (station == ST_COOK) {
+        for (int d = 0; d < sh->fSt.nDishes; d++) {
+            sh->fSt.dishPortions[d] += portions[d];
+            sh->fSt.nPortions += portions[d];
+        }
+        sh->fSt.chefBusy += busy;
+        sh->fSt.shelf.saved += saved;
+
+        /* Atualiza o seu estado, de novo para "à espera de um novo pedido" */
+        sh->fSt.st.chefStat = WAIT_FOR_ORDER;
+
+        /* Salvar as alterações efetuadas em memória partilhada (para imprimi-las corretamente em logging.c) */
+        saveState(nFic, &sh->fSt);
+    }
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                                      /* exit critical region */
+        perror ("error on the up operation for semaphore access (PT)");
+        exit (EXIT_FAILURE);
+    }
+    // ------------------------------------------------------------------------------ //
+
+    /* O trabalhador avisa os trabalhadores do posto seguinte de que há mais pedidos na sua fila */
+    for (int i = 0; i < batchSize; i++) {
+        if (semUp(semgid, sh->stationOrder[next]) == -1) {                                                    
+            perror ("error on the up operation for semaphore access (PT)");
+            exit (EXIT_FAILURE);
+        }
+    }
 }
 
 /**
  *  \brief chef cooks, then delivers the food to the waiter 
  *
- *  The chef takes some time to cook and signals the waiter that food is 
- *  ready (this may only happen when waiter is available) (waiterRequestPossible)
- *  then updates its state. (to WAIT_FOR_ORDER)
- *  The internal state should be saved.
+ *  The worker takes some time to work on the batch (see workTime) and passes its
+ *  orders on to the queue of the next station, blocking while it is full (the time
+ *  blocked is accounted as back-pressure). 
+ *  At the plate station the plates are handed to the waiter in one FOODREADY request
+ *  (this may only happen when waiter is available) (waiterRequestPossible); an order
+ *  goes through the stations as a whole, so the food of a table leaves the kitchen only
+ *  when all its dishes are ready.
+ *  If the waiter has not yet served a previous FOODREADY request, the plates just join
+ *  the ready plates and the worker does not wait for the waiter.
+ *  Updates its state (to WAIT_FOR_ORDER) and saves internal state (cook station).
  */
 static void processOrder ()
 {
+    PROBE1 (processOrder__entry, batchSize);
+
     /* 
-        O Chef começa a cozinhar no final da função waitForOrder() definida 
-        acima, quando passa para o estado COOK, demorando o tempo seguinte a fazê-lo: 
+        O trabalhador começa a trabalhar no final da função waitForOrder() definida 
+        acima, demorando o tempo seguinte a fazê-lo (no posto de cozinha, o tempo de 
+        preparação de cada prato do menu pedido no lote, mais o tempo marginal de cada 
+        pedido adicional do lote; nos outros, um tempo por dose); o conteúdo de cada 
+        pedido é lido diretamente no slab (sem cópia e sem a região crítica): 
     */
-    usleep((unsigned int) floor ((MAXCOOK * random ()) / RAND_MAX + 100.0));
-    /* *O Chef termina de cozinhar* */
+    long long start = timeNow();
+    int portions[MAXDISHES];
+    long long t = workTime(portions);
+    if (t > 0) {
+        usleep((unsigned int) t);
+    }
+    long long cooked = timeNow();
+    /* *O trabalhador termina* */
+
+    if (station != ST_PLATE) {
+        passOn(portions, cooked - start);
+        PROBE1 (processOrder__return, batchSize);
+        return;
+    }
+
+   // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1) {                                  /* enter critical region */
+        perror ("error on the up operation for semaphore access (PT)");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+
+    /* 
+        Os pratos do lote são colocados na lista de pratos prontos, de onde o Waiter os leva às mesas 
+        (função main()->takeFoodToTable() do Waiter). Só é preciso fazer um pedido ao Waiter se não 
+        houver já um pedido FOODREADY por atender (nesse caso, o Waiter leva também estes pratos)
+    */ 
+    for (int i = 0; i < batchSize; i++) {
+        sh->fSt.readyPlates[sh->fSt.readyCount++] = batch[i];
+        setGroupTime (&sh->fSt, batch[i].group, T_READY, cooked);
+    }
+    sh->fSt.station[station].busy += cooked - start;
+    bool request = !sh->fSt.readyPending;
+    sh->fSt.readyPending = true;
+
+    /* Atualiza o seu estado, de novo para "à espera de um novo pedido" */
+    traceState (WAIT_FOR_ORDER);
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                                      /* exit critical region */
+        perror ("error on the up operation for semaphore access (PT)");
+        exit (EXIT_FAILURE);
+    }
+    // ------------------------------------------------------------------------------ //
+
+    if (!request) {
+        PROBE1 (processOrder__return, batchSize);
+        return;
+    }
 
     /* O Chef espera pelo Waiter para que este fique disponível para levar a comida */
     if (semDown(semgid, sh->waiterRequestPossible) == -1) {                                                     
@@ -206,36 +647,28 @@ static void processOrder ()
         perror ("error on the up operation for semaphore access (PT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* 
-        Sendo que, acima, a variável 'lastGroup' foi usada para armazenar o ID do grupo que fez o pedido, 
-        aqui vai-se certificar de que o pedido vai ser entregue pelo Waiter ao grupo certo, que tem esse ID 
-        (função main()->takeFoodToTable() do Waiter), passando para a memória partilhada 
-        ('sh->fSt.waiterRequest.reqGroup' e 'sh->fSt.waiterRequest.reqType') tanto o ID desse grupo, 
-        como o tipo de request que o Waiter irá receber do Chef
-    */ 
-    sh->fSt.waiterRequest.reqGroup = lastGroup; 
+        Para o pedido ao Waiter, passa-se para a memória partilhada ('sh->fSt.waiterRequest.reqGroup' e 
+        'sh->fSt.waiterRequest.reqType') o ID do primeiro grupo do lote, e o tipo de request que o Waiter 
+        irá receber do Chef
+    */
+    sh->fSt.waiterRequest.reqGroup = batch[0].group; 
     sh->fSt.waiterRequest.reqType = FOODREADY;
+    traceFlow (FOODREADY, sh->fSt.readySeq++, true);
 
-    /* Indica que terminou um pedido, passando a variável/flag em memória partilhada de novo para 0 */
-    sh->fSt.foodOrder = 0;
-
-    /* Atualiza o seu estado, de novo para "à espera de um novo pedido" */
-    sh->fSt.st.chefStat = WAIT_FOR_ORDER;
-
-    /* Salvar as alterações efetuadas em memória partilhada (para imprimi-las corretamente em logging.c) */
-    saveState(nFic, &sh->fSt);
-
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                                      /* exit critical region */
         perror ("error on the up operation for semaphore access (PT)");
         exit (EXIT_FAILURE);
     }
     // ------------------------------------------------------------------------------ //
     
-    /* Por fim, o Chef informa o Waiter de que pode obter o pedido pronto e levá-lo */
+    /* Por fim, o Chef informa o Waiter de que pode obter os pedidos prontos e levá-los */
     if (semUp(semgid, sh->waiterRequest) == -1) {                                                      
         perror ("error on the up operation for semaphore access (PT)");
         exit (EXIT_FAILURE);
     }
+    PROBE1 (processOrder__return, batchSize);
 }
-
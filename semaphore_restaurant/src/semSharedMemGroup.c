@@ -6,13 +6,15 @@
  *  Synchronization based on semaphores and shared memory.
  *  Implementation with SVIPC.
  *
- *  Definition of the operations carried out by the groups:
+ *  Definition of the operations carried out by the groups (lived by the group agents, one visit at a time):
+ *     \li nextVisit
  *     \li goToRestaurant
  *     \li checkInAtReception
  *     \li orderFood
  *     \li waitFood
  *     \li eat
  *     \li checkOutAtReception
+ *     \li comeBack
  *
  *  \author Nuno Lau - December 2023
  */
@@ -31,6 +33,14 @@
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "timing.h"
+#include "slab.h"
+#include "trace.h"
+#include "probes.h"
+#include "histogram.h"
+#include "lifecycle.h"
+#include "arrival.h"
+#include "timer.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -44,24 +54,38 @@ static int semgid;
 /** \brief pointer to shared memory region */
 static SHARED_DATA *sh;
 
-static void goToRestaurant (int id);
-static void checkInAtReception (int id);
+/** \brief agent id of this process */
+static int agent;
+
+/** \brief how late (us) the agent woke up from its last sleep, until recorded (-1 if recorded) */
+static long long lateBy = -1;
+
+/** \brief time stamp (us) of the arrival of the group at the restaurant, in the present visit */
+static long long arrived;
+
+static int nextVisit (long long *since);
+static void goToRestaurant (int id, long long since);
+static bool checkInAtReception (int id);
 static void orderFood (int id);
 static void waitFood (int id);
 static void eat (int id);
 static void checkOutAtReception (int id);
+static void comeBack (int id);
+static void changeState (int id, unsigned int state);
 
 
 /**
  *  \brief Main program.
  *
- *  Its role is to generate the life cycle of one of intervening entities in the problem: the group.
+ *  Its role is to generate the life cycle of one of intervening entities in the problem: the group. The process is
+ *  a group agent, which lives the visits of the groups taken from the arrival queue, one at a time.
  */
 int main (int argc, char *argv[])
 {
     int key;                                         /*access key to shared memory and semaphore set */
     char *tinp;                                                    /* numerical parameters test flag */
     int n;   /* Group ID */
+    long long since;                                 /* time stamp from which the trip of the group is counted */
 
     /* validation of command line parameters */
     if (argc != 5) { 
@@ -74,10 +98,10 @@ int main (int argc, char *argv[])
        setbuf(stderr,NULL);
     }
 
-    /* Obtenção do Group ID */
-    n = (unsigned int) strtol (argv[1], &tinp, 0);
-    if ((*tinp != '\0') || (n >= MAXGROUPS )) { 
-        fprintf (stderr, "Group process identification is wrong!\n");
+    /* Obtenção do ID do agente */
+    agent = (unsigned int) strtol (argv[1], &tinp, 0);
+    if ((*tinp != '\0') || (agent >= MAXGROUPS )) { 
+        fprintf (stderr, "Group agent process identification is wrong!\n");
         return EXIT_FAILURE;
     }
     strcpy (nFic, argv[2]);
@@ -102,17 +126,29 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    /* initialize random generator */
-    srandom ((unsigned int) getpid ());                                                 
+    /* initialize random generator (reproducible if the run is seeded) */
+    srandom ((sh->fSt.seed != 0) ? sh->fSt.seed + U_GROUP + agent : (unsigned int) getpid ());
+
+
+    /* opening the trace track of the group agent (only if tracing is enabled) */
+    traceOpen (TR_GROUP, agent, GOTOREST);
+
+    /* simulation of the life cycle of the groups -> Indica o que cada Grupo vai fazer, um de cada vez */
+    while ((n = nextVisit(&since)) != -1) {     // Tirar o próximo grupo da fila de chegada (até ao fecho)
+        goToRestaurant(n, since);   // Ir para o restaurante
+        if (checkInAtReception(n)) {    // Fazer chek-in na receção (um grupo que não cabe em nenhuma mesa é recusado)
+            orderFood(n);           // Pedir comida
+            waitFood(n);            // Esperar pela comida
+            eat(n);                 // Comer
+            checkOutAtReception(n); // Fazer check-out na receção
+            comeBack(n);            // Em modo contínuo, voltar à fila de chegada (até ao fecho)
+        }
+    }
 
+    traceClose ();
 
-    /* simulation of the life cycle of the group -> Indica o que cada Grupo vai fazer */
-    goToRestaurant(n);          // Ir para o restaurante
-    checkInAtReception(n);      // Fazer chek-in na receção
-    orderFood(n);               // Pedir comida
-    waitFood(n);                // Esperar pela comida
-    eat(n);                     // Comer
-    checkOutAtReception(n);     // Fazer check-out na receção
+    /* Regista o nº de operações sobre semáforos (só este processo escreve no seu registo, que só é lido no fim) */
+    sh->fSt.usage[U_GROUP+agent].semOps = semOpCount ();
 
     /* unmapping the shared region off the process address space */
     if (shmemDettach (sh) == -1) {
@@ -143,21 +179,104 @@ static double normalRand(double stddev)
    return r*stddev;
 }
 
+/**
+ *  \brief group agent takes the next group
+ *
+ *  The agent waits for a group in the arrival queue and takes it, becoming the
+ *  one that lives its visit. An agent that finds the queue empty (the restaurant
+ *  is closing) passes the wake up on to the next one.
+ *
+ *  \param since time stamp from which the trip of the group is counted (filled in)
+ *
+ *  \return group id, or -1 if there are no more visits
+ */
+static int nextVisit (long long *since)
+{
+    int n;
+
+    /* O agente espera que haja um grupo na fila de chegada (ou que o restaurante feche) */
+    if (semDown(semgid, sh->groupArrival) == -1) {                                                
+        perror ("error on the down operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+
+    // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1) {                 /* enter critical region */
+        perror ("error on the down operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+
+    /* O agente tira o próximo grupo da fila e passa a ser ele a viver a visita do grupo */
+    n = arrivalPop(&sh->fSt, agent, since);
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
+        perror ("error on the up operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+    // ------------------------------------------------------------------------------ //
+
+    if (n == -1) {
+        /* A fila está vazia e não volta a encher: acorda-se o próximo agente, para que também termine */
+        if (semUp(semgid, sh->groupArrival) == -1) {                                                
+            perror ("error on the up operation for semaphore access (CT)");
+            exit (EXIT_FAILURE);
+        }
+    }
+    else traceState (GOTOREST);
+    return n;
+}
+
 /**
  *  \brief group goes to restaurant 
  *
- *  The group takes its time to get to restaurant.
+ *  The group takes its time to get to restaurant, counted from the moment it
+ *  was queued for its visit (an agent may only take it later).
  *
  *  \param id group id
+ *  \param since time stamp from which the trip of the group is counted
  */
-static void goToRestaurant (int id)
+static void goToRestaurant (int id, long long since)
 {
-    double startTime = sh->fSt.startTime[id] + normalRand(STARTDEV);
+    PROBE1 (goToRestaurant__entry, id);
+
+    long long due = since + (long long) (sh->fSt.startTime[id] + normalRand(STARTDEV));
+
+    /* O Grupo vai para o restaurante (acordado pela roda de temporizadores do launcher, se estiver ativa) */
+    if (timerSleep(sh, semgid, agent, due)) {
+        /* O Grupo chega ao restaurante; o atraso do acordar é registado na próxima região crítica */
+        lateBy = timeNow() - due;
+    }
+
+    /* Regista a hora de chegada (só este Grupo escreve no seu registo, que só é lido no fim) */
+    arrived = timeNow();
+    setGroupTime(&sh->fSt, id, T_ARRIVAL, arrived);
+    PROBE1 (goToRestaurant__return, id);
+}
 
-    if (startTime > 0.0) {
-        /* O Grupo começa a ir para o restaurante */
-        usleep((unsigned int) startTime );
-        /* O Grupo chega ao restaurante */
+/**
+ *  \brief group changes state
+ *
+ *  The new state is stamped in the lifecycle record of the group, the latencies
+ *  of the visit are recorded when the group leaves (see visitRecord), and how late
+ *  the agent woke up from its last sleep is recorded, if it was not yet.
+ *  Must be called within the critical region.
+ *
+ *  \param id group id
+ *  \param state new state
+ */
+static void changeState (int id, unsigned int state)
+{
+    setGroupState(&sh->fSt, id, state);
+    setGroupTime(&sh->fSt, id, state, timeNow());
+    if (state == LEAVING) {
+        visitRecord(&sh->fSt, id);                           /* a visita acaba: registam-se as suas latências */
+    }
+    traceState (state);
+    if (lateBy != -1) {
+        histRecord(&sh->fSt.wakeJitter, lateBy);
+        lateBy = -1;
     }
 }
 
@@ -170,13 +289,19 @@ static void goToRestaurant (int id)
  */
 static void eat (int id)
 {
+    PROBE1 (eat__entry, id);
+
     double eatTime = sh->fSt.eatTime[id] + normalRand(EATDEV);
     
     if (eatTime > 0.0) {
-        /* O Grupo começa a comer */
-        usleep((unsigned int) eatTime );
-        /* O Grupo termina de comer */
-    }
+        /* O Grupo começa a comer (acordado pela roda de temporizadores do launcher, se estiver ativa) */
+        long long due = timeNow() + (long long) eatTime;
+        if (timerSleep(sh, semgid, agent, due)) {
+            /* O Grupo termina de comer; o atraso do acordar é registado na próxima região crítica */
+            lateBy = timeNow() - due;
+        }
+    }
+    PROBE1 (eat__return, id);
 }
 
 /**
@@ -185,14 +310,17 @@ static void eat (int id)
  *  Group should, as soon as receptionist is available, ask for a table,
  *  signaling receptionist of the request.  
  *  Group may have to wait for a table in this method.
+ *  A group that does not fit the restaurant is turned away and leaves.
  *  The internal state should be saved.
  *
  *  \param id group id
  *
- *  \return true if first group, false otherwise  -> A função é void, não devolve nada!
+ *  \return true if group got a table, false if it was turned away
  */
-static void checkInAtReception(int id)
+static bool checkInAtReception(int id)
 {
+    PROBE1 (checkInAtReception__entry, id);
+
     /* O Grupo verifica primeiro se o Receptionist está disponível para falar com eles */
     if (semDown(semgid, sh->receptionistRequestPossible) == -1) {                                                
         perror ("error on the down operation for semaphore access (CT)");
@@ -205,17 +333,20 @@ static void checkInAtReception(int id)
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* O Grupo atualiza o seu estado para "na receção (à espera)" */
-    sh->fSt.st.groupStat[id] = ATRECEPTION;
+    changeState (id, ATRECEPTION);
 
     /* O Grupo faz o pedido ao Receptionist */
     sh->fSt.receptionistRequest.reqGroup = id;
     sh->fSt.receptionistRequest.reqType = TABLEREQ;
+    traceFlow (TABLEREQ, id, true);
 
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
         perror ("error on the up operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
@@ -229,10 +360,34 @@ static void checkInAtReception(int id)
     }
 
     /* Agora, os grupos precisam de esperar que uma mesa fique disponível */ 
-    if (semDown(semgid, sh->waitForTable[id]) == -1) {                                                
+    if (semDown(semgid, sh->waitForTable[agent]) == -1) {                                                
+        perror ("error on the down operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+
+    // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1) {                 /* enter critical region */
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
+
+    /* Se o Receptionist não lhe atribuiu mesa, o Grupo foi recusado e vai embora */
+    bool seated = (groupTable(&sh->fSt, id) != -1);
+    if (!seated) {
+        changeState (id, LEAVING);
+        saveState(nFic, &sh->fSt);
+    }
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
+        perror ("error on the up operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+    // ------------------------------------------------------------------------------ //
+
+    PROBE2 (checkInAtReception__return, id, seated);
+    return seated;
 }
 
 /**
@@ -240,6 +395,8 @@ static void checkInAtReception(int id)
  *
  *  The group should update its state, request food to the waiter and 
  *  wait for the waiter to receive the request.
+ *  The content of the order is written in a slab block beforehand, and only
+ *  its offset goes with the request.
  *  
  *  The internal state should be saved.
  *
@@ -247,6 +404,34 @@ static void checkInAtReception(int id)
  */
 static void orderFood (int id)
 {
+    PROBE1 (orderFood__entry, id);
+
+    /* 
+        O Grupo escreve o conteúdo do pedido num bloco do slab (fora da região crítica, o slab não 
+        precisa dela); o Waiter e o Chef lêem-no no mesmo sítio, e o Waiter liberta-o na entrega 
+    */
+    int portions[MAXDISHES] = { 0 }, nItems = 0;
+    for (int p = 0; p < sh->fSt.groupSize[id]; p++) {                 /* cada pessoa escolhe um prato do menu */
+        portions[random() % sh->fSt.nDishes]++;
+    }
+    for (int d = 0; d < sh->fSt.nDishes; d++) {
+        if (portions[d] > 0) nItems++;
+    }
+    uint32_t payload = slabAlloc(&sh->fSt.slab, sizeof (ORDERPAYLOAD) + nItems * sizeof (ORDERITEM));
+    if (payload == SLABNULL) {
+        fprintf (stderr, "error on allocating the order payload (CT)\n");
+        exit (EXIT_FAILURE);
+    }
+    ORDERPAYLOAD *order = slabPtr(&sh->fSt.slab, payload);
+    order->group = id;
+    order->nItems = 0;
+    for (int d = 0; d < sh->fSt.nDishes; d++) {
+        if (portions[d] > 0) {
+            order->item[order->nItems].dish = (uint16_t) d;
+            order->item[order->nItems++].quantity = (uint16_t) portions[d];
+        }
+    }
+
     /* Primeiro, o Grupo precisa de verificar se o Waiter está disponível para falar com eles */
     if (semDown(semgid, sh->waiterRequestPossible) == -1) {                                                
         perror ("error on the down operation for semaphore access (CT)");
@@ -260,23 +445,28 @@ static void orderFood (int id)
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* O Grupo precisa de atualizar o seu estado para "a pedir a comida" */
-    sh->fSt.st.groupStat[id] = FOOD_REQUEST;
+    changeState (id, FOOD_REQUEST);
 
-    /* E precisa de colocar o pedido ao Waiter (na zona partilhada) */
+    /* E precisa de colocar o pedido ao Waiter (na zona partilhada), com o prazo para a comida estar pronta */
     sh->fSt.waiterRequest.reqGroup = id;
     sh->fSt.waiterRequest.reqType = FOODREQ;
+    traceFlow (FOODREQ, id, true);
+    sh->fSt.waiterRequest.reqDeadline = groupTime(&sh->fSt, id, T_SEATED) + sh->fSt.serviceTarget;
+    sh->fSt.waiterRequest.reqPayload = payload;
 
     /* 
         Esta variável (abaixo) serve para saber qual é a mesa em que o Grupo se encontra, 
         para depois ser usada no Waiter acknowledge de que anotou o pedido (a seguir)
     */
-    int assignedTable = sh->fSt.assignedTable[id];
+    int assignedTable = groupTable(&sh->fSt, id);
 
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
         perror ("error on the up operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
@@ -297,6 +487,7 @@ static void orderFood (int id)
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    PROBE1 (orderFood__return, id);
 }
 
 /**
@@ -310,24 +501,28 @@ static void orderFood (int id)
  */
 static void waitFood (int id)
 {
+    PROBE1 (waitFood__entry, id);
+
     // ------------------------------ [Região crítica] ------------------------------ //
     if (semDown (semgid, sh->mutex) == -1) {                 /* enter critical region */
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* O Grupo atualiza o seu estado para "à espera da comida" */
-    sh->fSt.st.groupStat[id] = WAIT_FOR_FOOD;
+    changeState (id, WAIT_FOR_FOOD);
 
     /* 
         Esta variável (abaixo) serve para saber qual é a mesa em que o Grupo se encontra, 
         para depois ser usada no Waiter acknowledge de que a comida chegou (a seguir)
     */
-    int assignedTable = sh->fSt.assignedTable[id];
+    int assignedTable = groupTable(&sh->fSt, id);
 
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                   /* enter critical region */
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
@@ -352,18 +547,26 @@ static void waitFood (int id)
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* Sendo que pode começar a comer, então atualiza o seu estado para "a comer" */
-    sh->fSt.st.groupStat[id] = EAT;
+    changeState (id, EAT);
+
+    /* Em modo contínuo, regista quanto tempo passou desde a chegada até ser servido (janela de medida atual) */
+    if (sh->fSt.continuous) {
+        histRecord (&sh->fSt.serveWindow, timeNow() - arrived);
+    }
 
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                   /* enter critical region */
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
     // ------------------------------------------------------------------------------ //
+    PROBE1 (waitFood__return, id);
 }
 
 /**
@@ -379,6 +582,8 @@ static void waitFood (int id)
  */
 static void checkOutAtReception (int id)
 {
+    PROBE1 (checkOutAtReception__entry, id);
+
     /* O Grupo verifica se o Receptionist está disponível para falar com eles */
     if (semDown(semgid, sh->receptionistRequestPossible) == -1) {                                                
         perror ("error on the down operation for semaphore access (CT)");
@@ -392,26 +597,29 @@ static void checkOutAtReception (int id)
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* 
         Sendo que o Receptionist já se encontra disponível, o Grupo atualiza o seu 
         estado para "a pagar/checkout" 
     */
-    sh->fSt.st.groupStat[id] = CHECKOUT;
+    changeState (id, CHECKOUT);
 
     /* O Grupo faz o pedido de pagamento ao Receptionist */
     sh->fSt.receptionistRequest.reqGroup = id;
     sh->fSt.receptionistRequest.reqType = BILLREQ;
+    traceFlow (BILLREQ, id, true);
 
     /*  
         Esta variável serve para saber qual é a mesa em que o Grupo se encontra, para 
         depois ser usada no Receptionist acknowledge de que o pagamento está feito 
     */
-    int assignedTable = sh->fSt.assignedTable[id];
+    int assignedTable = groupTable(&sh->fSt, id);
 
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                   /* enter critical region */
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
@@ -442,17 +650,74 @@ static void checkOutAtReception (int id)
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* Agora que pagaram, o Grupo atualiza o seu estado para "a ir embora" */
-    sh->fSt.st.groupStat[id] = LEAVING;
+    changeState (id, LEAVING);
+    sh->fSt.nLeft++;
     
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                   /* enter critical region */
         perror ("error on the down operation for semaphore access (CT)");
         exit (EXIT_FAILURE);
     }
     // ------------------------------------------------------------------------------ //
+    PROBE1 (checkOutAtReception__return, id);
 }
 
+/**
+ *  \brief group decides whether to come back to the restaurant
+ *
+ *  In the continuous mode, a group that has left starts a new visit while the
+ *  restaurant is not closing: the visit is counted (and so is its order, for the
+ *  staff), the time stamps of the previous visit are forgotten, the group goes
+ *  back to GOTOREST and it is put at the end of the arrival queue, for the next
+ *  free agent. The internal state should be saved.
+ *
+ *  \param id group id
+ */
+static void comeBack (int id)
+{
+    bool back;
+
+    // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1) {                 /* enter critical region */
+        perror ("error on the down operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+
+    /* 
+        O Grupo só volta se o restaurante não estiver a fechar; a nova visita conta já para os totais 
+        que o Receptionist, o Waiter e o Chef têm de atender (dentro da região crítica, para que o fecho 
+        e os totais nunca se desencontrem) 
+    */
+    back = !sh->fSt.closing;
+    if (back) {
+        sh->fSt.nVisits++;
+        sh->fSt.nServed++;
+        clearGroupTimes (&sh->fSt, id, timeNow());
+        setGroupTable (&sh->fSt, id, -1);
+        changeState (id, GOTOREST);
+        arrivalPush (&sh->fSt, id, timeNow());
+
+        /* Salva-se o estado interno */
+        saveState(nFic, &sh->fSt);
+    }
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                   /* exit critical region */
+        perror ("error on the down operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+    // ------------------------------------------------------------------------------ //
+
+    /* O grupo que volta fica à espera de um agente livre na fila de chegada */
+    if (back && (semUp(semgid, sh->groupArrival) == -1)) {
+        perror ("error on the up operation for semaphore access (CT)");
+        exit (EXIT_FAILURE);
+    }
+}
@@ -29,6 +29,10 @@
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "seating.h"
+#include "timing.h"
+#include "trace.h"
+#include "probes.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -106,8 +110,8 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    /* initialize random generator */
-    srandom ((unsigned int) getpid ());              
+    /* initialize random generator (reproducible if the run is seeded) */
+    srandom ((sh->fSt.seed != 0) ? sh->fSt.seed + U_RECEPTIONIST : (unsigned int) getpid ());
 
 
     /* initialize internal receptionist memory -> Coloca todos os grupos como "a chegar" */
@@ -116,12 +120,22 @@ int main (int argc, char *argv[])
        groupRecord[g] = TOARRIVE;
     }
 
+    /* opening the trace track of the receptionist (only if tracing is enabled) */
+    traceOpen (TR_RECEPTIONIST, 0, WAIT_FOR_REQUEST);
+
     /* simulation of the life cycle of the receptionist -> Indica o que o Receptionist vai fazer */
     int nReq = 0;
     request req;
-    /* Enquanto o nº de requests for inferior ao máximo de requests possível para o Receptionist, executa este loop */
-    while( nReq < sh->fSt.nGroups*2 ) {     // nGroups (5) * 2 (requests feitos por Groups, um para mesa, outro para pagamento) = nTotalRequests
+    /* 
+        Enquanto o nº de requests for inferior ao máximo de requests possível para o Receptionist, executa este loop 
+        (em modo contínuo as visitas vão crescendo até ao fecho, e o launcher envia um pedido de fim de serviço) 
+    */
+    while( !sh->fSt.closing || (nReq < sh->fSt.nVisits + sh->fSt.nServed) ) {     // nVisits (5) + nServed (requests feitos por Groups, um para mesa, outro para pagamento, exceto os grupos recusados) = nTotalRequests
         req = waitForGroup();               // Receptionist ouve o pedido do Grupo
+        if (req.reqType == CLOSEREQ) {      // Fim de serviço (modo contínuo)
+            continue;
+        }
+        traceFlow (req.reqType, req.reqGroup, false);
         switch(req.reqType) {
             /* Se for um pedido de mesa, então atribui-lhes uma mesa, assim que possível */
             case TABLEREQ:
@@ -136,6 +150,11 @@ int main (int argc, char *argv[])
         nReq++; 
     }
 
+    traceClose ();
+
+    /* Regista o nº de operações sobre semáforos (só este processo escreve no seu registo, que só é lido no fim) */
+    sh->fSt.usage[U_RECEPTIONIST].semOps = semOpCount ();
+
     /* unmapping the shared region off the process address space */
     if (shmemDettach (sh) == -1) {
         perror ("error on unmapping the shared region off the process address space");
@@ -149,34 +168,17 @@ int main (int argc, char *argv[])
  *  \brief decides table to occupy for group n or if it must wait.
  *
  *  Checks current state of tables and groups in order to decide table or wait.
+ *  The table (or joined tables) is bound to the group by the seat assignment policy.
  *
  *  \return table id or -1 (in case of wait decision)
  */
 static int decideTableOrWait(int n) // Este método é chamado entre semáforos mutex, logo pode aceder à região partilhada sem problemas
 {   
     /* 
-        Sabe-se que, se um grupo não está a ocupar nenhuma mesa, o valor do índice que corresponde ao seu id no array 
-        'sh->fSt.assignedTable' é -1 (ver main() em 'probSemSharedMemRestaurant.c') 
+        A política de atribuição (first-fit, best-fit ou junção de mesas) procura no índice de mesas livres 
+        por capacidade uma mesa (ou conjunto de mesas) onde caiba o grupo; se não houver, retorna -1
     */
-    int mesa0 = 1;                                  // Mesa 0 inicialmente disponível
-    int mesa1 = 1;                                  // Mesa 1 inicialmente disponível
-    /* Percorreu-se o array tal como é feito na main() acima */
-    for (int group = 0; group < sh->fSt.nGroups; group++) { 
-        if (sh->fSt.assignedTable[group] == 0) {
-            mesa0 = 0; // Se a condição for verdadeira, significa que a mesa 0 não está disponível
-        }
-        if (sh->fSt.assignedTable[group] == 1) {
-            mesa1 = 0; // Se a condição for verdadeira, significa que a mesa 1 não está disponível
-        }
-    }    
-
-    /* Agora, tem de se verificar qual é que pode ser atribuída (se ambas tiverem sido assinaladas como ocupadas, retorna-se -1) */
-    if (mesa0)
-        return 0;
-    else if(mesa1)
-        return 1; 
-    else
-        return -1;       
+    return seatAssign(&sh->fSt, n, timeNow());
 }
 
 /**
@@ -184,14 +186,15 @@ static int decideTableOrWait(int n) // Este método é chamado entre semáforos
  *         to decide which group (if any) should occupy it.
  *
  *  Checks current state of tables and groups in order to decide group.
+ *  The first waiting group that fits the free tables is seated.
  *
  *  \return group id or -1 (in case of wait decision) -> Não seria "in case of no group waiting"
  */
 static int decideNextGroup() // Este método é chamado entre semáforos mutex, logo pode aceder à região partilhada sem problemas
 {
-    /* O ciclo seguinte encontra um grupo em espera e retorna o seu id, se existir algum */
+    /* O ciclo seguinte encontra um grupo em espera que caiba nas mesas livres, senta-o e retorna o seu id, se existir algum */
     for (int group = 0; group < sh->fSt.nGroups; group++) {
-        if (groupRecord[group] == WAIT) {
+        if ((groupRecord[group] == WAIT) && (seatAssign(&sh->fSt, group, timeNow()) != -1)) {
             return group;
         }
     }
@@ -210,6 +213,8 @@ static int decideNextGroup() // Este método é chamado entre semáforos mutex,
  */
 static request waitForGroup()
 {
+    PROBE0 (waitForGroup__entry);
+
     request ret; 
 
     // ------------------------------ [Região crítica] ------------------------------ //
@@ -217,11 +222,14 @@ static request waitForGroup()
         perror ("error on the up operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
     
     /* O Receptionist atualiza e salva o seu estado para "à espera de pedido de um Grupo" */
     sh->fSt.st.receptionistStat = WAIT_FOR_REQUEST;
+    traceState (WAIT_FOR_REQUEST);
     saveState(nFic, &sh->fSt);
     
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
         perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
@@ -246,10 +254,12 @@ static request waitForGroup()
         perror ("error on the up operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* Agora que o Grupo colocou o pedido na memória partilhada, o Receptionist pode lê-lo */
     ret = sh->fSt.receptionistRequest;
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
      perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
@@ -266,6 +276,7 @@ static request waitForGroup()
     }
 
     /* Devolve-se o pedido para o usar na main() */
+    PROBE2 (waitForGroup__return, ret.reqType, ret.reqGroup);
     return ret;
 }
          
@@ -281,18 +292,39 @@ static request waitForGroup()
  */
 static void provideTableOrWaitingRoom (int n)
 {
+    PROBE1 (provideTableOrWaitingRoom__entry, n);
+
     // ------------------------------ [Região crítica] ------------------------------ //
     if (semDown (semgid, sh->mutex) == -1)  {                /* enter critical region */
         perror ("error on the up operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* O Receptionist atualiza o seu estado para "a atribuir mesa ao grupo n" */
     sh->fSt.st.receptionistStat = ASSIGNTABLE;
+    traceState (ASSIGNTABLE);
 
     /* Salvam-se as alterações feitas ao estado */
     saveState(nFic, &sh->fSt);
 
+    /* Um grupo que não cabe no restaurante (nem com todas as mesas livres) é recusado e vai embora sem mesa */
+    if (!seatFeasible(&sh->fSt, sh->fSt.groupSize[n])) {
+        groupRecord[n] = DONE;
+        sh->fSt.nRejected++;
+        if (semUp(semgid, sh->waitForTable[groupAgent(&sh->fSt, n)]) == -1) {                                            
+            perror ("error on the down operation for semaphore access (WT)");
+            exit (EXIT_FAILURE);
+        }
+        seqEnd (sh);
+        if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
+            perror ("error on the down operation for semaphore access (WT)");
+            exit (EXIT_FAILURE);
+        }
+        PROBE2 (provideTableOrWaitingRoom__return, n, groupTable (&sh->fSt, n));
+        return;
+    }
+
     /* Verifica-se se existe alguma mesa disponível (ver função 'decideTableOrWait()', explicada acima) */
     int mesa = decideTableOrWait(n);
     if (mesa == -1) {
@@ -306,23 +338,24 @@ static void provideTableOrWaitingRoom (int n)
         sh->fSt.groupsWaiting++;
     } else {
         /*  
-            Se houver alguma mesa disponível, então este grupo fica com ela e o Receptionist avisa-o de que podem 
-            entrar para a mesa (semUp), atualizando, também, o seu groupRecord (não é necessário decrementar 
-            'sh->fSt.groupsWaiting')
+            Se houver alguma mesa disponível, então este grupo fica com ela (já registada em 'sh->fSt.assignedTable' 
+            por decideTableOrWait()) e o Receptionist avisa-o de que podem entrar para a mesa (semUp), atualizando, 
+            também, o seu groupRecord (não é necessário decrementar 'sh->fSt.groupsWaiting')
         */
-        sh->fSt.assignedTable[n] = mesa;
         groupRecord[n] = ATTABLE;
-        if (semUp(semgid, sh->waitForTable[n]) == -1) {                                            
+        if (semUp(semgid, sh->waitForTable[groupAgent(&sh->fSt, n)]) == -1) {                                            
             perror ("error on the down operation for semaphore access (WT)");
             exit (EXIT_FAILURE);
         }
     }
     
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
         perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
     // ------------------------------------------------------------------------------ //
+    PROBE2 (provideTableOrWaitingRoom__return, n, groupTable (&sh->fSt, n));
 }
 
 /**
@@ -337,14 +370,18 @@ static void provideTableOrWaitingRoom (int n)
 
 static void receivePayment (int n)
 {
+    PROBE1 (receivePayment__entry, n);
+
     // ------------------------------ [Região crítica] ------------------------------ //
     if (semDown (semgid, sh->mutex) == -1)  {                /* enter critical region */
         perror ("error on the up operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* O Receptionist atualiza o seu estado para "a receber o pagamento" */
     sh->fSt.st.receptionistStat = RECVPAY;
+    traceState (RECVPAY);
 
     /* Salvam-se e escrevem-se as alterações efetuadas ao estado (logging.c) */
     saveState(nFic, &sh->fSt);
@@ -354,20 +391,19 @@ static void receivePayment (int n)
         encontra, para depois ser usada no Receptionist acknowledge de que o pagamento 
         está feito, e ainda para ser atribuída a algum grupo que esteja em espera 
     */
-    int assignedTable = sh->fSt.assignedTable[n];
-
-    /* O Receptionist atualiza o estado da mesa, dizendo que já se encontra disponível */
-    sh->fSt.assignedTable[n] = -1;
+    /* O Receptionist liberta a(s) mesa(s) do grupo, dizendo que já se encontra(m) disponível(eis) */
+    int assignedTable = seatRelease(&sh->fSt, n, timeNow());
 
-    /* Verifica-se se ainda existem grupos à espera */
-    int nextGroup = decideNextGroup();
+    /* 
+        Verifica-se se ainda existem grupos à espera que caibam nas mesas livres (decideNextGroup() já lhes 
+        atribui a mesa); como as mesas têm capacidades diferentes, pode ser sentado mais do que um grupo
+    */
+    int nextGroup;
 
-    /* E, se existirem: */
-    if (nextGroup != -1) {
-        /* Atribui-se ao próximo Grupo a mesa que acabou de ser disponibilizada */
-        sh->fSt.assignedTable[nextGroup] = assignedTable;
+    /* E, enquanto existirem: */
+    while ((nextGroup = decideNextGroup()) != -1) {
         /* Avisa-se o grupo que podem ir para a mesa (podem deixar de esperar pela mesa) */
-        if (semUp(semgid, sh->waitForTable[nextGroup]) == -1) {                                         
+        if (semUp(semgid, sh->waitForTable[groupAgent(&sh->fSt, nextGroup)]) == -1) {                                         
             perror ("error on the down operation for semaphore access (WT)");
             exit (EXIT_FAILURE);
         }
@@ -377,6 +413,7 @@ static void receivePayment (int n)
         sh->fSt.groupsWaiting--;
     }
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1)  {                   /* exit critical region */
      perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
@@ -391,5 +428,6 @@ static void receivePayment (int n)
 
     /* Finalmente, o Receptionist atualiza o seu groupRecord do grupo 'n' para "feito" */
     groupRecord[n] = DONE;
+    PROBE1 (receivePayment__return, n);
 }
 
@@ -29,6 +29,11 @@
 #include "sharedDataSync.h"
 #include "semaphore.h"
 #include "sharedMemory.h"
+#include "timing.h"
+#include "kitchen.h"
+#include "slab.h"
+#include "trace.h"
+#include "probes.h"
 
 /** \brief logging file name */
 static char nFic[51];
@@ -46,10 +51,10 @@ static SHARED_DATA *sh;
 static request waitForClientOrChef ();
 
 /** \brief waiter takes food order to chef */
-static void informChef(int group);
+static void informChef(int group, long long deadline, uint32_t payload);
 
-/** \brief waiter takes food to table */
-static void takeFoodToTable (int group);
+/** \brief waiter takes all ready plates to their tables */
+static int takeFoodToTable (void);
 
 
 
@@ -97,29 +102,62 @@ int main (int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
-    /* initialize random generator */
-    srandom ((unsigned int) getpid ());              
+    /* initialize random generator (reproducible if the run is seeded) */
+    srandom ((sh->fSt.seed != 0) ? sh->fSt.seed + U_WAITER : (unsigned int) getpid ());
+
+    /* opening the trace track of the waiter (only if tracing is enabled) */
+    traceOpen (TR_WAITER, 0, WAIT_FOR_REQUEST);
 
     /* simulation of the life cycle of the waiter -> Indica o que o Waiter vai fazer */
-    int nReq = 0;
+    int nOrders = 0, nDelivered = 0, nReady = 0;
     request req;
-    /* Enquanto o nº de requests for inferior ao máximo de requests possível para o Waiter, executa este loop */
-    while( nReq < sh->fSt.nGroups*2 ) {     // nGroups (5) * 2 (requests feitos por Groups e requests feitos por Chef; a cada pedido do Grupo, existe uma resposta do Chef) = nTotalRequests
+    long long busy = 0, start;
+    /* 
+        Enquanto houver pedidos por anotar ou pratos por entregar, executa este loop: cada um dos nServed grupos 
+        servidos faz um pedido, e o Chef entrega os pratos em lotes (um request do Chef pode trazer vários pratos). 
+        Em modo contínuo os grupos voltam e nServed vai crescendo, por isso o Waiter só termina depois do fecho 
+        (o launcher envia-lhe um pedido de fim de serviço quando todos os grupos se foram embora) 
+    */
+    while( !sh->fSt.closing || (nOrders < sh->fSt.nServed) || (nDelivered < sh->fSt.nServed) ) {
         req = waitForClientOrChef();        // Waiter anota o pedido do Grupo/Chef
+        start = timeNow();                  // Início do atendimento (para medir a ocupação do Waiter)
         switch(req.reqType) {
             /* Se for o Grupo a fazer um pedido de refeição, então vai informar o Chef */
             case FOODREQ:  
-                   informChef(req.reqGroup); // Além de informar o pedido de comida, também diz qual foi o grupo que o fez
+                   traceFlow (FOODREQ, req.reqGroup, false);
+                   informChef(req.reqGroup, req.reqDeadline, req.reqPayload); // Além de informar o pedido de comida, também diz qual foi o grupo que o fez, o prazo e onde está o conteúdo do pedido
+                   nOrders++;
                    break;
-            /* Se o pedido for do Chef para levar a comida pronta à mesa, então o Waiter leva à mesa respetiva */       
+            /* Se o pedido for do Chef a avisar que há comida pronta, o Waiter leva todos os pratos prontos às mesas */
             case FOODREADY: 
-                   takeFoodToTable(req.reqGroup); // Leva a comida para a mesa onde está o grupo indicado como argumento
+                   traceFlow (FOODREADY, nReady++, false);
+                   nDelivered += takeFoodToTable(); // Leva os pratos prontos (não só os do grupo do pedido) às mesas dos grupos respetivos
+                   break;
+            /* Fim de serviço (modo contínuo): não há mais nada a fazer, o ciclo termina */
+            case CLOSEREQ:
                    break;
         }
-        /* Incrementa o nº de pedidos */
-        nReq++; 
+        busy += timeNow() - start;
+    }
+
+    /* Regista o tempo que o Waiter passou a atender pedidos */
+    if (semDown (semgid, sh->mutex) == -1)  {                /* enter critical region */
+        perror ("error on the up operation for semaphore access (WT)");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+    sh->fSt.waiterBusy = busy;
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {                    /* exit critical region */
+        perror ("error on the down operation for semaphore access (WT)");
+        exit (EXIT_FAILURE);
     }
 
+    traceClose ();
+
+    /* Regista o nº de operações sobre semáforos (só este processo escreve no seu registo, que só é lido no fim) */
+    sh->fSt.usage[U_WAITER].semOps = semOpCount ();
+
     /* unmapping the shared region off the process address space */
     if (shmemDettach (sh) == -1) {
         perror ("error on unmapping the shared region off the process address space");
@@ -140,6 +178,8 @@ int main (int argc, char *argv[])
  */
 static request waitForClientOrChef()
 {
+    PROBE0 (waitForClientOrChef__entry);
+
     request req; 
 
     // ------------------------------ [Região crítica] ------------------------------ //
@@ -147,16 +187,19 @@ static request waitForClientOrChef()
         perror ("error on the up operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* 
         O Waiter atualiza o seu estado para "à espera de um pedido" (de um Grupo para fazer 
         um pedido, ou do Chef para levar a comida à mesa) 
     */
     sh->fSt.st.waiterStat = WAIT_FOR_REQUEST;
+    traceState (WAIT_FOR_REQUEST);
 
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
     
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1)      {               /* exit critical region */
         perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
@@ -186,10 +229,12 @@ static request waitForClientOrChef()
         perror ("error on the up operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* Então, o Waiter lê o pedido que foi colocado por Group ou Chef na região crítica */
     req = sh->fSt.waiterRequest;
 
+    seqEnd (sh);
     if (semUp(semgid, sh->mutex) == -1) {                     /* exit critical region */
         perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
@@ -209,6 +254,7 @@ static request waitForClientOrChef()
         exit (EXIT_FAILURE);
     }
 
+    PROBE2 (waitForClientOrChef__return, req.reqType, req.reqGroup);
     return req;
 }
 
@@ -217,37 +263,39 @@ static request waitForClientOrChef()
  *
  *  Waiter updates state and then takes food request to chef.
  *  Waiter should inform group that request is received.
- *  Waiter should wait for chef receiving request.
+ *  The order is put into the kitchen order queue and the waiter returns at once;
+ *  it only waits for the chef if the queue is full.
  *  The internal state should be saved.
  *
+ *  \param n group id
+ *  \param deadline time stamp (us) by which the food should be ready
+ *  \param payload offset of the order payload in the slab (only the offset is queued, the chef reads it in place)
  */
-static void informChef (int n)
+static void informChef (int n, long long deadline, uint32_t payload)
 {
+    PROBE1 (informChef__entry, n);
+
     // ------------------------------ [Região crítica] ------------------------------ //
     if (semDown (semgid, sh->mutex) == -1)  {                /* enter critical region */
         perror ("error on the up operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    seqBegin (sh);
 
     /* O Waiter atualiza o seu estado para "a ir informar Chef sobre o pedido do Grupo 'n'" */
     sh->fSt.st.waiterStat = INFORM_CHEF;
-
-    /* 
-        O Waiter indica ao Chef que existe um pedido pendente e indica o grupo que o fez, 
-        acedendo à memória partilhada para o fazer 
-    */
-    sh->fSt.foodOrder = 1;
-    sh->fSt.foodGroup = n;
+    traceState (INFORM_CHEF);
 
     /* 
         Aqui, o Waiter obtém a mesa que foi dada ao grupo n, para depois poder dar o acknowledge 
         respetivo ao Grupo, sobre ter anotado o pedido 
     */
-    int assignedTable = sh->fSt.assignedTable[n];
+    int assignedTable = groupTable(&sh->fSt, n);
     
     /* Salva-se o estado interno */
     saveState(nFic, &sh->fSt);
 
+    seqEnd (sh);
     if (semUp (semgid, sh->mutex) == -1)                      /* exit critical region */
     { perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
@@ -260,64 +308,135 @@ static void informChef (int n)
         exit (EXIT_FAILURE);
     } 
 
+    /* O Waiter só fica à espera do Chef se a fila de pedidos da cozinha estiver cheia */
+    long long stallStart = timeNow();
+    if (semDown (semgid, sh->orderSlot) == -1)      {                                             
+        perror ("error on the down operation for semaphore access (WT)");
+        exit (EXIT_FAILURE);
+    } 
+    long long stall = timeNow() - stallStart;
+
+    // ------------------------------ [Região crítica] ------------------------------ //
+    if (semDown (semgid, sh->mutex) == -1)  {                /* enter critical region */
+        perror ("error on the up operation for semaphore access (WT)");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+
     /* 
-        O Waiter leva o pedido ao Chef, dizendo-lhe que pode parar de esperar pelo pedido 
-        e começar a cozinhar (COOK) 
+        O Waiter coloca o pedido do grupo 'n' na fila de pedidos da cozinha (ordenada pela política da cozinha),
+        que é a fila do primeiro posto da cozinha 
     */
-    if (semUp (semgid, sh->waitOrder) == -1)      {                                             
-        perror ("error on the down operation for semaphore access (WT)");
+    ORDER order = { .group = n, .deadline = deadline, .payload = payload };
+    long long now = timeNow();
+    stationPush(&sh->fSt, ST_PREP, order, now);
+    setGroupTime(&sh->fSt, n, T_ORDER, now);
+    setGroupTime(&sh->fSt, n, T_DEADLINE, deadline);
+    sh->fSt.waiterStall += stall;
+
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1)                      /* exit critical region */
+    { perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
     }
+    // ------------------------------------------------------------------------------ //
 
-    /* O Waiter espera agora que o Chef lhe confirma que recebeu o pedido que lhe passou */
-    if (semDown (semgid, sh->orderReceived) == -1)      {                                             
+    /* 
+        O Waiter avisa o Chef de que há mais um pedido na fila, e volta logo a atender outros 
+        pedidos; o Chef retira-o da fila quando puder
+    */
+    if (semUp (semgid, sh->waitOrder) == -1)      {                                             
         perror ("error on the down operation for semaphore access (WT)");
         exit (EXIT_FAILURE);
-    } 
+    }
+    PROBE1 (informChef__return, n);
 }
 
 /**
  *  \brief waiter takes food to table 
  *
  *  Waiter updates its state and takes food to table, allowing the meal to start.
- *  Group must be informed that food is available.
+ *  All the plates the chef has ready are delivered, carrying up to maxPlates
+ *  plates per trip; each group must be informed that food is available.
+ *  The payloads of the orders delivered are freed.
  *  The internal state should be saved.
+ *  The group named in the FOODREADY request is not needed: the plates come from
+ *  the ready plates of the kitchen, whatever group the chef named.
  *
+ *  \return number of plates delivered
  */
 
-static void takeFoodToTable (int n)
+static int takeFoodToTable (void)
 {
-    // ------------------------------ [Região crítica] ------------------------------ //
-    if (semDown (semgid, sh->mutex) == -1)  {                /* enter critical region */
-        perror ("error on the up operation for semaphore access (WT)");
-        exit (EXIT_FAILURE);
-    }
+    PROBE1 (takeFoodToTable__entry, __atomic_load_n (&sh->fSt.readyCount, __ATOMIC_RELAXED));
+
+    int plates[MAXORDERS];
+    uint32_t payloads[MAXORDERS];
+    int nPlates, delivered = 0;
+    bool more;
+
+    do {
+        // ------------------------------ [Região crítica] ------------------------------ //
+        if (semDown (semgid, sh->mutex) == -1)  {                /* enter critical region */
+            perror ("error on the up operation for semaphore access (WT)");
+            exit (EXIT_FAILURE);
+        }
+        seqBegin (sh);
+
+        /* O Waiter atualiza o seu estado para "a ir levar a comida às mesas" */
+        sh->fSt.st.waiterStat = TAKE_TO_TABLE;
+        traceState (TAKE_TO_TABLE);
+
+        /* 
+            Aqui, o Waiter pega nos pratos prontos mais antigos (no máximo maxPlates por viagem) e obtém as 
+            mesas dos grupos respetivos, para depois poder dar o acknowledge a cada Grupo, sobre a comida ter chegado 
+        */
+        nPlates = (sh->fSt.readyCount < sh->fSt.maxPlates) ? sh->fSt.readyCount : sh->fSt.maxPlates;
+        for (int i = 0; i < nPlates; i++) {
+            plates[i] = groupTable (&sh->fSt, sh->fSt.readyPlates[i].group);
+            payloads[i] = sh->fSt.readyPlates[i].payload;
+        }
+        sh->fSt.readyCount -= nPlates;
+        memmove(sh->fSt.readyPlates, sh->fSt.readyPlates + nPlates, sh->fSt.readyCount * sizeof (ORDER));
 
-    /* O Waiter atualiza o seu estado para "a ir levar a comida à mesa do grupo 'n'" */
-    sh->fSt.st.waiterStat = TAKE_TO_TABLE;
+        /* Se ficarem pratos, o Waiter faz mais viagens; senão, o Chef terá de fazer um novo pedido FOODREADY */
+        more = (sh->fSt.readyCount > 0);
+        if (!more) {
+            sh->fSt.readyPending = false;
+        }
+        sh->fSt.nTrips++;
+        sh->fSt.tripPlates[nPlates]++;
 
-    /* 
-        Aqui, o Waiter obtém a mesa que foi dada ao grupo n, para depois poder dar o 
-        acknowledge respetivo ao Grupo, sobre a comida ter chegado 
-    */
-    int assignedTable = sh->fSt.assignedTable[n];
+        /* Salva-se o estado interno */
+        saveState(nFic, &sh->fSt);
 
-    /* Salva-se o estado interno */
-    saveState(nFic, &sh->fSt);
+        seqEnd (sh);
+        if (semUp (semgid, sh->mutex) == -1)  {                   /* exit critical region */
+            perror ("error on the down operation for semaphore access (WT)");
+            exit (EXIT_FAILURE);
+        }
+        // ------------------------------------------------------------------------------ //
 
-    if (semUp (semgid, sh->mutex) == -1)  {                   /* exit critical region */
-        perror ("error on the down operation for semaphore access (WT)");
-        exit (EXIT_FAILURE);
-    }
-    // ------------------------------------------------------------------------------ //
+        /* O Waiter leva os pratos às mesas */
+        if (sh->fSt.tripTime > 0) {
+            usleep((unsigned int) sh->fSt.tripTime);
+        }
 
-    /* 
-        O Waiter informa o grupo 'n' que a comida está pronta e já chegou, e que podem, 
-        então começar a comer (EAT) 
-    */
-    if (semUp(semgid, sh->foodArrived[assignedTable]) == -1)      {                                             
-        perror ("error on the down operation for semaphore access (WT)");
-        exit (EXIT_FAILURE);
-    }     
-}
+        /* 
+            O Waiter informa cada grupo de que a comida está pronta e já chegou, e que podem, 
+            então começar a comer (EAT); os pedidos entregues já não são precisos, e o seu 
+            conteúdo é libertado (o slab não precisa da região crítica)
+        */
+        for (int i = 0; i < nPlates; i++) {
+            slabFree(&sh->fSt.slab, payloads[i]);
+            if (semUp(semgid, sh->foodArrived[plates[i]]) == -1)      {                                             
+                perror ("error on the down operation for semaphore access (WT)");
+                exit (EXIT_FAILURE);
+            }     
+        }
+        delivered += nPlates;
+    } while (more);
 
+    PROBE1 (takeFoodToTable__return, delivered);
+    return delivered;
+}
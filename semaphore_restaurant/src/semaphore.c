@@ -9,20 +9,32 @@
  *     \li destruction of a previously created set of semaphores
  *     \li signalling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>down</em> of a semaphore within the set, without blocking
+ *     \li <em>down</em> of a semaphore within the set, blocking for a limited time
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li number of operations done by the process.
  *
  *  \author António Rui Borges - October 1995
  */
 
+#define _GNU_SOURCE                                                            /* semtimedop */
+
 #include <stdio.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
 #include <sys/sem.h>
 #include <assert.h>
 
+#include "timing.h"
+#include "trace.h"
+
 /** \brief access permission: user r-w */
 #define  MASK           0600
 
+/** \brief number of down and up operations done by this process */
+static long long semOps = 0;
+
 /**
  *  \brief Creation of a set of semaphores.
  *
@@ -113,12 +125,73 @@ int semSignal (int semgid)
 int semDown (int semgid, unsigned int sindex)
 {
   struct sembuf down = { 0, -1, 0 };                                                      /* specific down operation */
+  long long t0 = traceOn () ? timeNowNs () : 0;                               /* start of the wait, when tracing */
+  int ret;
 
   assert(sindex>0);
   down.sem_num = (unsigned short) sindex;
+  semOps += 1;
+  ret = semop (semgid, &down, 1);
+  if (t0 != 0)
+     traceSemWait (sindex, t0, timeNowNs ());
+  return ret;
+}
+
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, without blocking.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>
+ *  or if the semaphore is in <em>red state</em>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>, which is set to
+ *          <tt>EAGAIN</tt> if the semaphore is in red state)
+ */
+
+int semTryDown (int semgid, unsigned int sindex)
+{
+  struct sembuf down = { 0, -1, IPC_NOWAIT };                                  /* specific non blocking down operation */
+
+  assert(sindex>0);
+  down.sem_num = (unsigned short) sindex;
+  semOps += 1;
   return semop (semgid, &down, 1);
 }
 
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, blocking for a limited time.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>
+ *  or if the semaphore is still in <em>red state</em> when the time runs out.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param timeout longest time to wait (us)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>, which is set to
+ *          <tt>EAGAIN</tt> if the time ran out)
+ */
+
+int semTimedDown (int semgid, unsigned int sindex, long timeout)
+{
+  struct sembuf down = { 0, -1, 0 };                                                      /* specific down operation */
+  struct timespec limit = { timeout / 1000000, (timeout % 1000000) * 1000 };
+  long long t0 = traceOn () ? timeNowNs () : 0;                               /* start of the wait, when tracing */
+  int ret;
+
+  assert(sindex>0);
+  down.sem_num = (unsigned short) sindex;
+  semOps += 1;
+  ret = semtimedop (semgid, &down, 1, &limit);
+  if (t0 != 0)
+     traceSemWait (sindex, t0, timeNowNs ());
+  return ret;
+}
+
 /**
  *  \brief <em>Up</em> of a semaphore within the set.
  *
@@ -137,5 +210,19 @@ int semUp (int semgid, unsigned int sindex)
 
   assert(sindex>0);
   up.sem_num = (unsigned short) sindex;
+  semOps += 1;
   return semop (semgid, &up, 1);
 }
+
+/**
+ *  \brief Number of operations done by the process.
+ *
+ *  Counts the calls of <em>down</em>, non blocking and timed <em>down</em> and <em>up</em> (one system call each).
+ *
+ *  \return number of operations since the process started
+ */
+
+long long semOpCount (void)
+{
+  return semOps;
+}
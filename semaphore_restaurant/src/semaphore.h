@@ -9,7 +9,10 @@
  *     \li destruction of a previously created set of semaphores
  *     \li signalling start of operations
  *     \li <em>down</em> of a semaphore within the set
- *     \li <em>up</em> of a semaphore within the set.
+ *     \li <em>down</em> of a semaphore within the set, without blocking
+ *     \li <em>down</em> of a semaphore within the set, blocking for a limited time
+ *     \li <em>up</em> of a semaphore within the set
+ *     \li number of operations done by the process.
  *
  *  \author António Rui Borges - October 1995
  */
@@ -85,6 +88,39 @@ extern int semSignal (int semgid);
 
 extern int semDown (int semgid, unsigned int sindex);
 
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, without blocking.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>
+ *  or if the semaphore is in <em>red state</em>.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>, which is set to
+ *          <tt>EAGAIN</tt> if the semaphore is in red state)
+ */
+
+extern int semTryDown (int semgid, unsigned int sindex);
+
+/**
+ *  \brief <em>Down</em> of a semaphore within the set, blocking for a limited time.
+ *
+ *  The function fails if there is no semaphore set with an identifier equal to <tt>semgid</tt>
+ *  or if the semaphore is still in <em>red state</em> when the time runs out.
+ *
+ *  \param semgid set identifier
+ *  \param sindex semaphore location in the set (1 .. snum)
+ *  \param timeout longest time to wait (us)
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>, which is set to
+ *          <tt>EAGAIN</tt> if the time ran out)
+ */
+
+extern int semTimedDown (int semgid, unsigned int sindex, long timeout);
+
 /**
  *  \brief <em>Up</em> of a semaphore within the set.
  *
@@ -99,4 +135,21 @@ extern int semDown (int semgid, unsigned int sindex);
 
 extern int semUp (int semgid, unsigned int sindex);
 
+/**
+ *  \brief Number of operations done by the process.
+ *
+ *  Counts the calls of <em>down</em>, non blocking and timed <em>down</em> and <em>up</em> (one system call each).
+ *
+ *  \return number of operations since the process started
+ */
+
+extern long long semOpCount (void);
+
+/* instrumentation build: down and up are profiled per call site (see csprof.h) */
+#if defined (CSPROF) && !defined (CSPROF_IMPL)
+#include "csprof.h"
+#define semDown(semgid, sindex)     csprofDown (semgid, sindex, __FILE__, __func__, __LINE__)
+#define semUp(semgid, sindex)       csprofUp (semgid, sindex)
+#endif
+
 #endif /* SEMAPHORE_H_ */
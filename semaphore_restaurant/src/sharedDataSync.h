@@ -30,9 +30,11 @@
 typedef struct
         { /** \brief full state of the problem */
           FULL_STAT fSt;
-          /* semaphores ids */
+          /** \brief sequence counter of the updates of the full state (odd while an update is in progress) */
+          unsigned int seq CACHEALIGNED;
+          /* semaphores ids (read-only once the simulation starts, away from the lines that are written) */
           /** \brief identification of critical region protection semaphore – val = 1 */
-          unsigned int mutex;
+          unsigned int mutex CACHEALIGNED;
           /** \brief identification of semaphore used by receptionist to wait for groups - val = 0 */
           unsigned int receptionistReq; 
           /** \brief identification of semaphore used by groups to wait before issuing receptionist request - val = 1 */
@@ -41,12 +43,22 @@ typedef struct
           unsigned int waiterRequest;
           /** \brief identification of semaphore used by groups and chef to wait before issuing waiter request - val = 1 */
           unsigned int waiterRequestPossible;
-          /** \brief identification of semaphore used by chef to wait for order – val = 0  */
+          /** \brief identification of semaphore used by chef to wait for order (counts queued orders) – val = 0  */
           unsigned int waitOrder;
-          /** \brief identification of semaphore used by waiter to wait for chef – val = 0  */
-          unsigned int orderReceived;
-          /** \brief identification of semaphore used by groups to wait for table – val = 0 */
+          /** \brief identification of semaphore used by waiter to wait for room in the kitchen order queue – val = orderQueueSize  */
+          unsigned int orderSlot;
+          /** \brief identification of semaphore used by group agents to wait for a group (counts queued groups) – val = nGroups */
+          unsigned int groupArrival;
+          /** \brief identification of semaphore used by the timer thread to wait for timers (counts posted timers) – val = 0 */
+          unsigned int timerReq;
+          /** \brief identification of semaphores used by the workers of each station to wait for orders (waitOrder for the first) – val = 0 */
+          unsigned int stationOrder[NSTATIONS];
+          /** \brief identification of semaphores used to wait for room in the queue of each station (orderSlot for the first) – val = capacity */
+          unsigned int stationSlot[NSTATIONS];
+          /** \brief identification of semaphore used by groups to wait for table, one per group agent – val = 0 */
           unsigned int waitForTable[MAXGROUPS]; 
+          /** \brief identification of semaphore used by group agents to wait for their timer, one per agent – val = 0 */
+          unsigned int timerExpired[MAXGROUPS];
           /** \brief identification of semaphore used by groups to wait for waiter ackowledge – val = 0  */
           unsigned int requestReceived[NUMTABLES];
           /** \brief identification of semaphore used by groups to wait for food – val = 0 */
@@ -56,8 +68,23 @@ typedef struct
 
         } SHARED_DATA;
 
+/*
+ *  Consistent snapshots without the mutex (seqlock).
+ *  Every critical region brackets its updates with seqBegin and seqEnd, right after the down and right before the up
+ *  of the mutex, so the writers are already serialized. A reader that must not take the mutex (e.g. restmon) reads
+ *  the counter, copies the shared data and reads the counter again: the copy is consistent if both values are equal
+ *  and even.
+ */
+
+/** \brief start of an update of the shared data (must follow the down of the mutex) */
+#define seqBegin(sh)         do { __atomic_store_n (&(sh)->seq, (sh)->seq + 1, __ATOMIC_RELAXED); \
+                                  __atomic_thread_fence (__ATOMIC_RELEASE); } while (0)
+
+/** \brief end of an update of the shared data (must precede the up of the mutex) */
+#define seqEnd(sh)           __atomic_store_n (&(sh)->seq, (sh)->seq + 1, __ATOMIC_RELEASE)
+
 /** \brief number of semaphores in the set */
-#define SEM_NU               ( 7 + sh->fSt.nGroups + 3*NUMTABLES )
+#define SEM_NU               ( 9 + 2*(NSTATIONS-1) + 2*sh->fSt.nAgents + 3*NUMTABLES )
 
 #define MUTEX                        1
 #define RECEPTIONISTREQ              2
@@ -65,9 +92,14 @@ typedef struct
 #define WAITERREQUEST                4
 #define WAITERREQUESTPOSSIBLE        5
 #define WAITORDER                    6
-#define ORDERRECEIVED                7
-#define WAITFORTABLE                 8 
-#define FOODARRIVED                  (WAITFORTABLE+sh->fSt.nGroups)
+#define ORDERSLOT                    7
+#define GROUPARRIVAL                 8
+#define TIMERREQ                     9
+#define STATIONORDER                 (TIMERREQ+1-ST_COOK)                    /* + station, from ST_COOK on */
+#define STATIONSLOT                  (STATIONORDER+NSTATIONS-1)              /* + station, from ST_COOK on */
+#define WAITFORTABLE                 (STATIONSLOT+NSTATIONS) 
+#define TIMEREXPIRED                 (WAITFORTABLE+sh->fSt.nAgents)
+#define FOODARRIVED                  (TIMEREXPIRED+sh->fSt.nAgents)
 #define REQUESTRECEIVED              (FOODARRIVED+NUMTABLES)
 #define TABLEDONE                    (REQUESTRECEIVED+NUMTABLES)
 
@@ -8,18 +8,227 @@
  *      \li connection to a previously created block
  *      \li destruction of a previously created block
  *      \li mapping of the block previously created on the process address space
+ *      \li read-only mapping of the block previously created on the process address space
  *      \li unmapping of the block off the process address space.
  *
+ *  Two backends are available, selected at run time by the environment variable SHMEMENV (see sharedMemory.h):
+ *  System V (shmget / shmat, the default) and POSIX (shm_open / mmap). Both accept options to back the blocks
+ *  with huge pages, to prefault them on mapping and to lock them in memory.
+ *
  *  \author António Rui Borges - October 1995
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <sys/types.h>
+#include <sys/ipc.h>
 #include <sys/shm.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "sharedMemory.h"
 
 /** \brief access permission: user r-w */
 #define  MASK           0600
 
+/** \brief maximum number of blocks of the POSIX backend a process can have open at the same time */
+#define  MAXBLOCKS      16
+
+/** \brief maximum length of the name of a block */
+#define  NAMELEN        64
+
+/** \brief mount point of hugetlbfs, where the blocks of the POSIX backend backed by huge pages live */
+#define  HUGETLBFS      "/dev/hugepages"
+
+/** \brief size of a huge page (blocks backed by huge pages are rounded up to a multiple of it) */
+#define  HUGEPAGE       (2UL << 20)
+
+/** \brief options of the backend (parsed from SHMEMENV on first use) */
+static struct {
+  bool parsed;                                                                       /* SHMEMENV was parsed */
+  bool posix;                                                           /* POSIX backend (System V otherwise) */
+  bool hugetlb;                                                                       /* explicit huge pages */
+  bool thp;                                                                      /* transparent huge pages */
+  bool populate;                                                                  /* prefault on mapping */
+  bool lock;                                                                         /* lock in memory */
+} opt;
+
+/** \brief block of the POSIX backend open by this process */
+typedef struct {
+  int fd;                                                                     /* descriptor (-1 if free) */
+  int key;                                                                               /* creation key */
+  bool private;                                                         /* created with key IPC_PRIVATE */
+  bool removed;                                                  /* destroyed while still mapped */
+  void *add;                                                          /* address of the mapping (or NULL) */
+  size_t size;                                                                       /* size of the mapping */
+} BLOCK;
+
+/** \brief blocks of the POSIX backend open by this process */
+static BLOCK block[MAXBLOCKS];
+
+/* internal functions */
+
+/** \brief parsing the options of the backend; false if SHMEMENV is malformed */
+static bool setup (void)
+{
+  char spec[NAMELEN], *tok;
+  char *env = getenv (SHMEMENV);
+  int b;
+
+  if (opt.parsed)
+     return true;
+  for (b = 0; b < MAXBLOCKS; b++)
+    block[b].fd = -1;
+  if (env != NULL)
+     { snprintf (spec, sizeof (spec), "%s", env);
+       for (tok = strtok (spec, ","); tok != NULL; tok = strtok (NULL, ","))
+         if (strcmp (tok, "sysv") == 0) opt.posix = false;
+            else if (strcmp (tok, "posix") == 0) opt.posix = true;
+            else if (strcmp (tok, "hugetlb") == 0) opt.hugetlb = true;
+            else if (strcmp (tok, "thp") == 0) opt.thp = true;
+            else if (strcmp (tok, "populate") == 0) opt.populate = true;
+            else if (strcmp (tok, "lock") == 0) opt.lock = true;
+            else { errno = EINVAL;
+                   return false;
+                 }
+     }
+  opt.parsed = true;
+  return true;
+}
+
+/** \brief name of a block of the POSIX backend */
+static void blockName (int key, char name[])
+{
+  if (opt.hugetlb)
+     snprintf (name, NAMELEN, "%s/restaurant.%x", HUGETLBFS, (unsigned int) key);
+     else snprintf (name, NAMELEN, "/restaurant.%x", (unsigned int) key);
+}
+
+/** \brief opening a block of the POSIX backend */
+static int blockOpen (const char *name, int flags)
+{
+  return opt.hugetlb ? open (name, flags, MASK) : shm_open (name, flags, MASK);
+}
+
+/** \brief removing the name of a block of the POSIX backend */
+static int blockUnlink (const char *name)
+{
+  return opt.hugetlb ? unlink (name) : shm_unlink (name);
+}
+
+/** \brief entry of the table of blocks with a descriptor or a mapping (NULL if there is none) */
+static BLOCK *blockFind (int fd, void *add)
+{
+  int b;
+
+  for (b = 0; b < MAXBLOCKS; b++)
+    if ((block[b].fd != -1) && ((fd == -1) ? (block[b].add == add) : (block[b].fd == fd)))
+       return &block[b];
+  return NULL;
+}
+
+/** \brief registering a descriptor in the table of blocks */
+static int blockAdd (int fd, int key, bool private)
+{
+  BLOCK *blk;
+  int b;
+
+  for (b = 0, blk = NULL; (b < MAXBLOCKS) && (blk == NULL); b++)
+    if (block[b].fd == -1)
+       blk = &block[b];
+  if (blk == NULL)
+     { close (fd);
+       errno = EMFILE;
+       return -1;
+     }
+  blk->fd = fd;
+  blk->key = key;
+  blk->private = private;
+  blk->removed = false;
+  blk->add = NULL;
+  blk->size = 0;
+  return fd;
+}
+
+/** \brief making a new mapping of a block resident: huge pages, prefaulting and locking, as requested */
+static int settle (void *add, size_t size)
+{
+  volatile char *p;
+  size_t off, page = (size_t) sysconf (_SC_PAGESIZE);
+
+  if (opt.thp && (madvise (add, size, MADV_HUGEPAGE) == -1))
+     return -1;
+  if (opt.populate)                                             /* touch every page, so that no access faults later */
+     for (p = (volatile char *) add, off = 0; off < size; off += page)
+       (void) p[off];
+  if (opt.lock && (mlock (add, size) == -1))
+     return -1;
+  return 0;
+}
+
+/** \brief mapping of a block of the System V backend */
+static int sysvAttach (int shmid, void **pAttAdd, int flags)
+{
+  struct shmid_ds ds;
+  void *add;                                                                                    /* temporary pointer */
+  int err;
+
+  add = shmat (shmid, (char *) NULL, flags);
+  if (add == (void *) -1)
+     return -1;
+  if ((opt.thp || opt.populate || opt.lock) &&
+      ((shmctl (shmid, IPC_STAT, &ds) == -1) || (settle (add, ds.shm_segsz) == -1)))
+     { err = errno;
+       shmdt (add);
+       errno = err;
+       return -1;
+     }
+  *pAttAdd = (void *) add;
+  return 0;
+}
+
+/** \brief mapping of a block of the POSIX backend */
+static int posixAttach (int fd, void **pAttAdd, int prot)
+{
+  struct stat st;
+  BLOCK *blk;
+  void *add;                                                                                    /* temporary pointer */
+  int flags = MAP_SHARED, err;
+
+  if ((blk = blockFind (fd, NULL)) == NULL)
+     { errno = EINVAL;
+       return -1;
+     }
+  if (blk->add != NULL)                                                         /* one mapping per block and process */
+     { *pAttAdd = blk->add;
+       return 0;
+     }
+  if (fstat (fd, &st) == -1)
+     return -1;
+  if (opt.populate && !opt.thp)                          /* the kernel prefaults; with thp, after the advice */
+     flags |= MAP_POPULATE;
+  add = mmap (NULL, (size_t) st.st_size, prot, flags, fd, 0);
+  if (add == MAP_FAILED)
+     return -1;
+  if (settle (add, (size_t) st.st_size) == -1)
+     { err = errno;
+       munmap (add, (size_t) st.st_size);
+       errno = err;
+       return -1;
+     }
+  blk->add = add;
+  blk->size = (size_t) st.st_size;
+  *pAttAdd = add;
+  return 0;
+}
+
+/* external functions */
+
 /**
  *  \brief Creation of a new block.
  *
@@ -34,7 +243,34 @@
 
 int shmemCreate (int key, unsigned int size)
 {
-  return shmget ((key_t) key, size, MASK | IPC_CREAT | IPC_EXCL);
+  static int nPrivate = 0;                                             /* number of private blocks created */
+  char name[NAMELEN];
+  size_t len = size;
+  int fd;
+
+  if (!setup ())
+     return -1;
+  if (opt.hugetlb)
+     len = (len + HUGEPAGE - 1) / HUGEPAGE * HUGEPAGE;
+  if (!opt.posix)
+     return shmget ((key_t) key, len, MASK | IPC_CREAT | IPC_EXCL | (opt.hugetlb ? SHM_HUGETLB : 0));
+
+  if (key == IPC_PRIVATE)                                   /* a unique name, removed as soon as it is open */
+     { if (opt.hugetlb)
+          snprintf (name, NAMELEN, "%s/restaurant.p%d.%d", HUGETLBFS, (int) getpid (), nPrivate++);
+          else snprintf (name, NAMELEN, "/restaurant.p%d.%d", (int) getpid (), nPrivate++);
+     }
+     else blockName (key, name);
+  if ((fd = blockOpen (name, O_RDWR | O_CREAT | O_EXCL)) == -1)
+     return -1;
+  if (ftruncate (fd, (off_t) len) == -1)
+     { close (fd);
+       blockUnlink (name);
+       return -1;
+     }
+  if (key == IPC_PRIVATE)
+     blockUnlink (name);
+  return blockAdd (fd, key, key == IPC_PRIVATE);
 }
 
 /**
@@ -50,7 +286,32 @@ int shmemCreate (int key, unsigned int size)
 
 int shmemConnect (int key)
 {
-  return shmget ((key_t) key, 1, MASK);
+  struct stat st, stOld;
+  char name[NAMELEN];
+  BLOCK *blk;
+  int fd, b;
+
+  if (!setup ())
+     return -1;
+  if (!opt.posix)
+     return shmget ((key_t) key, 1, MASK);
+
+  blockName (key, name);
+  if ((fd = blockOpen (name, O_RDWR)) == -1)
+     return -1;
+  if (fstat (fd, &st) == -1)
+     { close (fd);
+       return -1;
+     }
+  for (b = 0; b < MAXBLOCKS; b++)                      /* the same block gets the same identifier, as with shmget */
+    { blk = &block[b];
+      if ((blk->fd != -1) && !blk->private && (blk->key == key) && (fstat (blk->fd, &stOld) == 0) &&
+          (stOld.st_dev == st.st_dev) && (stOld.st_ino == st.st_ino))
+         { close (fd);
+           return blk->fd;
+         }
+    }
+  return blockAdd (fd, key, false);
 }
 
 /**
@@ -66,7 +327,27 @@ int shmemConnect (int key)
 
 int shmemDestroy (int shmid)
 {
-  return shmctl (shmid, IPC_RMID, (struct shmid_ds *) NULL);
+  char name[NAMELEN];
+  BLOCK *blk;
+
+  if (!setup ())
+     return -1;
+  if (!opt.posix)
+     return shmctl (shmid, IPC_RMID, (struct shmid_ds *) NULL);
+
+  if ((blk = blockFind (shmid, NULL)) == NULL)
+     { errno = EINVAL;
+       return -1;
+     }
+  blockName (blk->key, name);
+  if (!blk->private && (blockUnlink (name) == -1))
+     return -1;
+  if (blk->add != NULL)                                           /* still mapped: released on unmapping */
+     blk->removed = true;
+     else { close (blk->fd);
+            blk->fd = -1;
+          }
+  return 0;
 }
 
 /**
@@ -83,14 +364,29 @@ int shmemDestroy (int shmid)
 
 int shmemAttach (int shmid, void **pAttAdd)
 {
-  void *add;                                                                                    /* temporary pointer */
+  if (!setup ())
+     return -1;
+  return opt.posix ? posixAttach (shmid, pAttAdd, PROT_READ | PROT_WRITE) : sysvAttach (shmid, pAttAdd, 0);
+}
 
-  add = shmat (shmid, (char *) NULL, 0);
-  if (add != (void *) -1)
-     { *pAttAdd = (void *) add;
-       return 0;
-     }
-     else return 1;
+/**
+ *  \brief Read-only mapping of the block previously created on the process address space.
+ *
+ *  The function fails if there is no block with an identifier equal to <tt>shmid</tt>.
+ *  Any attempt to write on the block through the mapping raises a segmentation fault.
+ *
+ *  \param shmid block identifier
+ *  \param pAttAdd pointer to the location where the local address of the attached block is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+int shmemAttachReadOnly (int shmid, void **pAttAdd)
+{
+  if (!setup ())
+     return -1;
+  return opt.posix ? posixAttach (shmid, pAttAdd, PROT_READ) : sysvAttach (shmid, pAttAdd, SHM_RDONLY);
 }
 
 /**
@@ -107,5 +403,23 @@ int shmemAttach (int shmid, void **pAttAdd)
 
 int shmemDettach (void *attAdd)
 {
-  return shmdt (attAdd);
+  BLOCK *blk;
+
+  if (!setup ())
+     return -1;
+  if (!opt.posix)
+     return shmdt (attAdd);
+
+  if ((blk = blockFind (-1, attAdd)) == NULL)
+     { errno = EINVAL;
+       return -1;
+     }
+  if (munmap (blk->add, blk->size) == -1)
+     return -1;
+  blk->add = NULL;
+  if (blk->removed)                                                             /* the block is gone for good */
+     { close (blk->fd);
+       blk->fd = -1;
+     }
+  return 0;
 }
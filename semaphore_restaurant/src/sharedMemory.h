@@ -8,14 +8,29 @@
  *      \li connection to a previously created block
  *      \li destruction of a previously created block
  *      \li mapping of the block previously created on the process address space
+ *      \li read-only mapping of the block previously created on the process address space
  *      \li unmapping of the block off the process address space.
  *
+ *  The backend is selected by the environment variable SHMEMENV, a comma separated list of
+ *     \li <tt>sysv</tt> System V shared memory (shmget / shmat), the default
+ *     \li <tt>posix</tt> POSIX shared memory (shm_open / mmap), one object <tt>/restaurant.key</tt> per block
+ *     \li <tt>hugetlb</tt> blocks backed by explicit huge pages (SHM_HUGETLB, or a file in hugetlbfs
+ *         for the POSIX backend); the pages must be reserved beforehand (vm.nr_hugepages)
+ *     \li <tt>thp</tt> transparent huge pages requested for every mapping (madvise)
+ *     \li <tt>populate</tt> every page of a mapping is faulted in when it is made (MAP_POPULATE)
+ *     \li <tt>lock</tt> every mapping is locked in memory (mlock).
+ *
+ *  All processes sharing a block must use the same backend, so the variable must be set before they start.
+ *
  *  \author António Rui Borges - October 1995
  */
 
 #ifndef SHAREDMEMORY_H_
 #define SHAREDMEMORY_H_
 
+/** \brief environment variable selecting the backend and its options */
+#define  SHMEMENV           "RESTAURANT_SHM"
+
 /**
  *  \brief Creation of a new block.
  *
@@ -70,6 +85,21 @@ extern int shmemDestroy (int shmid);
 
 extern int shmemAttach (int shmid, void **pAttAdd);
 
+/**
+ *  \brief Read-only mapping of the block previously created on the process address space.
+ *
+ *  The function fails if there is no block with an identifier equal to <tt>shmid</tt>.
+ *  Any attempt to write on the block through the mapping raises a segmentation fault.
+ *
+ *  \param shmid block identifier
+ *  \param pAttAdd pointer to the location where the local address of the attached block is stored
+ *
+ *  \return \c 0, upon success
+ *  \return -\c 1, when an error occurs (the actual situation is reported in <tt>errno</tt>)
+ */
+
+extern int shmemAttachReadOnly (int shmid, void **pAttAdd);
+
 /**
  *  \brief Unmapping of the block off the process address space.
  *
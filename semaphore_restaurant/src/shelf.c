@@ -0,0 +1,159 @@
+/**
+ *  \file shelf.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Prep-ahead shelf of the kitchen.
+ *
+ *  Defined operations:
+ *     \li initialization of the shelf
+ *     \li taking portions of a dish off the shelf for an order
+ *     \li choice of the dish to pre-cook
+ *     \li putting pre-cooked portions on the shelf.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "shelf.h"
+
+/* internal functions */
+
+/** \brief removal of the portion at position i of the shelf */
+static void removeAt (SHELF *sf, int i)
+{
+    for (; i + 1 < sf->count; i++) {
+        sf->dish[i] = sf->dish[i+1];
+        sf->cooked[i] = sf->cooked[i+1];
+    }
+    sf->count--;
+}
+
+/** \brief throwing away the portions that have spoiled */
+static void discardSpoiled (SHELF *sf, long long now)
+{
+    while ((sf->count > 0) && (now - sf->cooked[0] > sf->spoil)) {          /* the oldest portions come first */
+        removeAt (sf, 0);
+        sf->nSpoiled++;
+    }
+}
+
+/* external functions */
+
+/**
+ *  \brief Initialization of the shelf.
+ *
+ *  The shelf becomes empty and the popularity model forgets all orders. The capacity, the spoilage time and the
+ *  idle time must have been set.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+void shelfInit (FULL_STAT *p_fSt)
+{
+    SHELF *sf = &p_fSt->shelf;
+    int d;
+
+    for (d = 0; d < MAXDISHES; d++) {
+        sf->pending[d] = sf->demand[d] = 0;
+    }
+    sf->count = sf->nDemand = sf->nCooked = sf->nHits = sf->nOrderHits = sf->nSpoiled = 0;
+    sf->busy = sf->saved = 0;
+}
+
+/**
+ *  \brief Taking portions of a dish off the shelf for an order.
+ *
+ *  The portions asked for are added to the popularity model; the oldest fresh portions of the dish are taken.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param dish dish
+ *  \param n number of portions asked for
+ *  \param now present time stamp (us)
+ *
+ *  \return number of portions taken off the shelf (0 .. n)
+ */
+int shelfTake (FULL_STAT *p_fSt, int dish, int n, long long now)
+{
+    SHELF *sf = &p_fSt->shelf;
+    int i = 0, taken = 0;
+
+    sf->demand[dish] += n;
+    sf->nDemand += n;
+    discardSpoiled (sf, now);
+    while ((i < sf->count) && (taken < n)) {
+        if (sf->dish[i] == dish) {
+            removeAt (sf, i);
+            taken++;
+        }
+        else i++;
+    }
+    sf->nHits += taken;
+    return taken;
+}
+
+/**
+ *  \brief Choice of the dish to pre-cook.
+ *
+ *  The room for the portions is reserved until they are put on the shelf.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param now present time stamp (us)
+ *  \param n number of portions to pre-cook (filled in)
+ *
+ *  \return dish to pre-cook, or -\c 1 if the shelf is stocked as the model predicts (or nothing was ordered yet)
+ */
+int shelfPlan (FULL_STAT *p_fSt, long long now, int *n)
+{
+    SHELF *sf = &p_fSt->shelf;
+    int stock[MAXDISHES];
+    int d, i, target, room, best = -1, deficit = 0;
+
+    if (sf->nDemand == 0) {
+        return -1;
+    }
+    discardSpoiled (sf, now);
+    room = sf->capacity - sf->count;
+    for (d = 0; d < p_fSt->nDishes; d++) {
+        stock[d] = sf->pending[d];
+        room -= sf->pending[d];
+    }
+    for (i = 0; i < sf->count; i++) {
+        stock[sf->dish[i]]++;
+    }
+    for (d = 0; d < p_fSt->nDishes; d++) {
+        target = (sf->capacity * sf->demand[d] + sf->nDemand - 1) / sf->nDemand;       /* share of the shelf */
+        if (target - stock[d] > deficit) {
+            deficit = target - stock[d];
+            best = d;
+        }
+    }
+    if ((best == -1) || (room <= 0)) {
+        return -1;
+    }
+    *n = (deficit < room) ? deficit : room;
+    sf->pending[best] += *n;
+    return best;
+}
+
+/**
+ *  \brief Putting pre-cooked portions on the shelf.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param dish dish, as chosen by shelfPlan
+ *  \param n number of portions, as chosen by shelfPlan
+ *  \param now present time stamp (us)
+ */
+void shelfStock (FULL_STAT *p_fSt, int dish, int n, long long now)
+{
+    SHELF *sf = &p_fSt->shelf;
+    int k;
+
+    sf->pending[dish] -= n;
+    for (k = 0; k < n; k++) {
+        sf->dish[sf->count] = dish;
+        sf->cooked[sf->count++] = now;
+    }
+    sf->nCooked += n;
+}
@@ -0,0 +1,72 @@
+/**
+ *  \file shelf.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Prep-ahead shelf of the kitchen.
+ *
+ *  Defined operations:
+ *     \li initialization of the shelf
+ *     \li taking portions of a dish off the shelf for an order
+ *     \li choice of the dish to pre-cook
+ *     \li putting pre-cooked portions on the shelf.
+ *
+ *  The popularity model is the share of each dish in the portions asked for by the orders so far: an idle cook
+ *  pre-cooks the dish whose stock (on the shelf and being pre-cooked) falls furthest below its share of the shelf.
+ *  Portions older than the spoilage time are thrown away whenever the shelf is looked at.
+ *  The operations must be called within the critical region.
+ */
+
+#ifndef SHELF_H_
+#define SHELF_H_
+
+#include "probDataStruct.h"
+
+/**
+ *  \brief Initialization of the shelf.
+ *
+ *  The shelf becomes empty and the popularity model forgets all orders. The capacity, the spoilage time and the
+ *  idle time must have been set.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ */
+extern void shelfInit (FULL_STAT *p_fSt);
+
+/**
+ *  \brief Taking portions of a dish off the shelf for an order.
+ *
+ *  The portions asked for are added to the popularity model; the oldest fresh portions of the dish are taken.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param dish dish
+ *  \param n number of portions asked for
+ *  \param now present time stamp (us)
+ *
+ *  \return number of portions taken off the shelf (0 .. n)
+ */
+extern int shelfTake (FULL_STAT *p_fSt, int dish, int n, long long now);
+
+/**
+ *  \brief Choice of the dish to pre-cook.
+ *
+ *  The room for the portions is reserved until they are put on the shelf.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param now present time stamp (us)
+ *  \param n number of portions to pre-cook (filled in)
+ *
+ *  \return dish to pre-cook, or -\c 1 if the shelf is stocked as the model predicts (or nothing was ordered yet)
+ */
+extern int shelfPlan (FULL_STAT *p_fSt, long long now, int *n);
+
+/**
+ *  \brief Putting pre-cooked portions on the shelf.
+ *
+ *  \param p_fSt pointer to the location where the full internal state of the problem is stored
+ *  \param dish dish, as chosen by shelfPlan
+ *  \param n number of portions, as chosen by shelfPlan
+ *  \param now present time stamp (us)
+ */
+extern void shelfStock (FULL_STAT *p_fSt, int dish, int n, long long now);
+
+#endif /* SHELF_H_ */
@@ -0,0 +1,146 @@
+/**
+ *  \file slab.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Order payload slab.
+ *
+ *  Defined operations:
+ *     \li initialization of the slab
+ *     \li allocation of a block
+ *     \li address of a block
+ *     \li release of a block.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "slab.h"
+
+/* internal functions */
+
+/** \brief block size of a class */
+static uint32_t blockSize (int c)
+{
+    return (uint32_t) SLABMIN << c;
+}
+
+/** \brief offset of the first block of a class */
+static uint32_t classBase (int c)
+{
+    return SLABBLOCKS * SLABMIN * ((1u << c) - 1);
+}
+
+/** \brief taking the first block off the free list of a class (-1 if empty) */
+static int pop (SLAB *s, int c)
+{
+    uint64_t head = __atomic_load_n (&s->head[c], __ATOMIC_ACQUIRE), new;
+    uint32_t top;
+
+    do {
+        if ((top = (uint32_t) head) == 0) {
+            return -1;
+        }
+        new = (((head >> 32) + 1) << 32) | __atomic_load_n (&s->next[c][top-1], __ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n (&s->head[c], &head, new, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+    return (int) top - 1;
+}
+
+/** \brief putting a block back on the free list of a class */
+static void push (SLAB *s, int c, int b)
+{
+    uint64_t head = __atomic_load_n (&s->head[c], __ATOMIC_RELAXED), new;
+
+    do {
+        __atomic_store_n (&s->next[c][b], (uint32_t) head, __ATOMIC_RELAXED);
+        new = (((head >> 32) + 1) << 32) | (uint32_t) (b + 1);
+    } while (!__atomic_compare_exchange_n (&s->head[c], &head, new, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/* external functions */
+
+/**
+ *  \brief Initialization of the slab.
+ *
+ *  All blocks become free. Must be called before the processes that use the slab are started.
+ *
+ *  \param s pointer to the slab
+ */
+void slabInit (SLAB *s)
+{
+    int c, b;
+
+    for (c = 0; c < SLABCLASSES; c++) {
+        for (b = 0; b < SLABBLOCKS; b++) {
+            s->next[c][b] = (b + 1 < SLABBLOCKS) ? b + 2 : 0;
+        }
+        s->head[c] = 1;
+    }
+    s->nAlloc = s->nFailed = s->inUse = s->peak = 0;
+}
+
+/**
+ *  \brief Allocation of a block.
+ *
+ *  The block is taken from the smallest class that fits the size, or from a larger one if that class is exhausted.
+ *
+ *  \param s pointer to the slab
+ *  \param size number of bytes needed
+ *
+ *  \return offset of the block, or \c SLABNULL if no free block fits the size
+ */
+uint32_t slabAlloc (SLAB *s, size_t size)
+{
+    unsigned int used, peak;
+    int c, b;
+
+    for (c = 0; c < SLABCLASSES; c++) {
+        if ((size <= blockSize (c)) && ((b = pop (s, c)) != -1)) {
+            __atomic_fetch_add (&s->nAlloc, 1, __ATOMIC_RELAXED);
+            used = __atomic_add_fetch (&s->inUse, 1, __ATOMIC_RELAXED);
+            peak = __atomic_load_n (&s->peak, __ATOMIC_RELAXED);
+            while ((used > peak) &&
+                   !__atomic_compare_exchange_n (&s->peak, &peak, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                ;
+            return classBase (c) + b * blockSize (c);
+        }
+    }
+    __atomic_fetch_add (&s->nFailed, 1, __ATOMIC_RELAXED);
+    return SLABNULL;
+}
+
+/**
+ *  \brief Address of a block in the address space of the calling process.
+ *
+ *  \param s pointer to the slab
+ *  \param off offset of the block
+ *
+ *  \return address of the block
+ */
+void *slabPtr (SLAB *s, uint32_t off)
+{
+    return s->arena + off;
+}
+
+/**
+ *  \brief Release of a block.
+ *
+ *  \param s pointer to the slab
+ *  \param off offset of the block (\c SLABNULL is ignored)
+ */
+void slabFree (SLAB *s, uint32_t off)
+{
+    int c = 0;
+
+    if (off == SLABNULL) {
+        return;
+    }
+    while ((c + 1 < SLABCLASSES) && (off >= classBase (c + 1))) {
+        c++;
+    }
+    push (s, c, (off - classBase (c)) / blockSize (c));
+    __atomic_fetch_sub (&s->inUse, 1, __ATOMIC_RELAXED);
+}
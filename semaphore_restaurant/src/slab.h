@@ -0,0 +1,71 @@
+/**
+ *  \file slab.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Order payload slab.
+ *
+ *  Defined operations:
+ *     \li initialization of the slab
+ *     \li allocation of a block
+ *     \li address of a block
+ *     \li release of a block.
+ *
+ *  The slab lives in the shared region and hands out blocks of SLABCLASSES size classes. A block is named by its
+ *  offset in the slab, which is the same in every process and fits a request, so the payload of an order is written
+ *  once by the group and read in place by the waiter and the chef. The free list of each class is a Treiber stack
+ *  whose head carries a tag bumped on every change (no ABA), so the operations need not be called within the
+ *  critical region.
+ */
+
+#ifndef SLAB_H_
+#define SLAB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "probDataStruct.h"
+
+/** \brief offset of no block */
+#define  SLABNULL           UINT32_MAX
+
+/**
+ *  \brief Initialization of the slab.
+ *
+ *  All blocks become free. Must be called before the processes that use the slab are started.
+ *
+ *  \param s pointer to the slab
+ */
+extern void slabInit (SLAB *s);
+
+/**
+ *  \brief Allocation of a block.
+ *
+ *  The block is taken from the smallest class that fits the size, or from a larger one if that class is exhausted.
+ *
+ *  \param s pointer to the slab
+ *  \param size number of bytes needed
+ *
+ *  \return offset of the block, or \c SLABNULL if no free block fits the size
+ */
+extern uint32_t slabAlloc (SLAB *s, size_t size);
+
+/**
+ *  \brief Address of a block in the address space of the calling process.
+ *
+ *  \param s pointer to the slab
+ *  \param off offset of the block
+ *
+ *  \return address of the block
+ */
+extern void *slabPtr (SLAB *s, uint32_t off);
+
+/**
+ *  \brief Release of a block.
+ *
+ *  \param s pointer to the slab
+ *  \param off offset of the block (\c SLABNULL is ignored)
+ */
+extern void slabFree (SLAB *s, uint32_t off);
+
+#endif /* SLAB_H_ */
@@ -0,0 +1,217 @@
+/**
+ *  \file soak.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Continuous service mode of the launcher.
+ *
+ *  Defined operations:
+ *     \li serving continuously, with one line of measurements per window
+ *     \li ending the service, once all groups are gone.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "histogram.h"
+#include "timing.h"
+#include "soak.h"
+
+/** \brief flag of end of service requested by a signal */
+static volatile sig_atomic_t stopRequested = 0;
+
+/** \brief time from arrival to the food being served of the visits of the last window */
+static HISTOGRAM win;
+
+/** \brief time from arrival to the food being served of the visits of all windows */
+static HISTOGRAM total;
+
+/* internal functions */
+
+/** \brief handler of SIGINT and SIGTERM */
+static void stop (int sig)
+{
+    stopRequested = 1;
+}
+
+/** \brief resident memory (KB) of a process (0 if it is gone) */
+static long residentKB (pid_t pid)
+{
+    char name[32];
+    long size, pages = 0;
+    FILE *fp;
+
+    snprintf (name, sizeof (name), "/proc/%d/statm", (int) pid);
+    if ((fp = fopen (name, "r")) == NULL) {
+        return 0;
+    }
+    if (fscanf (fp, "%ld %ld", &size, &pages) != 2) {
+        pages = 0;
+    }
+    fclose (fp);
+    return pages * (sysconf (_SC_PAGESIZE) / 1024);
+}
+
+/** \brief entering the critical region */
+static void lock (SHARED_DATA *sh, int semgid)
+{
+    if (semDown (semgid, sh->mutex) == -1) {
+        perror ("error on the down operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+    seqBegin (sh);
+}
+
+/** \brief leaving the critical region */
+static void unlock (SHARED_DATA *sh, int semgid)
+{
+    seqEnd (sh);
+    if (semUp (semgid, sh->mutex) == -1) {
+        perror ("error on the up operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+}
+
+/** \brief issuing an end of service request through a request slot */
+static void closeRequest (SHARED_DATA *sh, int semgid, request *slot, unsigned int possible, unsigned int req)
+{
+    if (semDown (semgid, possible) == -1) {
+        perror ("error on the down operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+    lock (sh, semgid);
+    *slot = (request) { .reqType = CLOSEREQ, .reqGroup = -1 };
+    unlock (sh, semgid);
+    if (semUp (semgid, req) == -1) {
+        perror ("error on the up operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+}
+
+/* external functions */
+
+/**
+ *  \brief Serving continuously, with one line of measurements per window.
+ *
+ *  Returns when the duration of the service has elapsed or SIGINT or SIGTERM was received, after closing the
+ *  restaurant to new visits and printing a summary of all windows. Must be called after the start of operations.
+ *
+ *  \param fic stream where the measurements are printed
+ *  \param sh pointer to the shared region
+ *  \param semgid semaphore set access identifier
+ *  \param staff process identifiers of the staff (chef, waiter and receptionist)
+ */
+void soakRun (FILE *fic, SHARED_DATA *sh, int semgid, pid_t staff[3])
+{
+    struct sigaction sa = { .sa_handler = stop };
+    long long start = sh->fSt.runStart, end = start + sh->fSt.duration * 1000LL, next, now;
+    long rss, rssFirst = 0, rssLast = 0;
+    unsigned int inUse, inUsePeak = 0;
+    int left, prevLeft = 0, visits, minVisits = 0, maxVisits = 0, nWin = 0, s, w;
+    pid_t pid;
+
+    sigemptyset (&sa.sa_mask);
+    if ((sigaction (SIGINT, &sa, NULL) == -1) || (sigaction (SIGTERM, &sa, NULL) == -1)) {
+        perror ("error on installing the end of service handler");
+        exit (EXIT_FAILURE);
+    }
+    histInit (&total);
+
+    fprintf (fic, "%8s %9s %8s %9s %10s %10s %10s %9s %9s\n", "window", "end (s)", "visits", "visits/s",
+             "p50 (ms)", "p99 (ms)", "max (ms)", "payloads", "rss (KB)");
+    for (next = start + sh->fSt.window * 1000LL; !stopRequested; next += sh->fSt.window * 1000LL) {
+        while (!stopRequested && ((now = timeNow ()) < next)) {
+            usleep ((unsigned int) (next - now));                          /* a signal cuts the sleep short */
+        }
+        if (stopRequested) {
+            break;
+        }
+
+        /* the measurements of the window are taken and the window is restarted */
+        lock (sh, semgid);
+        win = sh->fSt.serveWindow;
+        histInit (&sh->fSt.serveWindow);
+        left = sh->fSt.nLeft;
+        unlock (sh, semgid);
+        inUse = __atomic_load_n (&sh->fSt.slab.inUse, __ATOMIC_RELAXED);
+
+        for (rss = residentKB (getpid ()), s = 0; s < 3; s++) {
+            rss += residentKB (staff[s]);
+        }
+        for (s = 0; s < NSTATIONS; s++) {                                  /* the kitchen workers forked by the chef */
+            for (w = 0; w < sh->fSt.station[s].workers; w++) {
+                if ((pid = __atomic_load_n (&sh->fSt.station[s].pid[w], __ATOMIC_RELAXED)) != 0) {
+                    rss += residentKB (pid);
+                }
+            }
+        }
+        visits = left - prevLeft;
+        prevLeft = left;
+        if ((nWin == 0) || (visits < minVisits)) minVisits = visits;
+        if ((nWin == 0) || (visits > maxVisits)) maxVisits = visits;
+        if (nWin == 0) rssFirst = rss;
+        rssLast = rss;
+        if (inUse > inUsePeak) inUsePeak = inUse;
+        histMerge (&total, &win);
+        nWin += 1;
+        fprintf (fic, "%8d %9.3f %8d %9.1f %10.3f %10.3f %10.3f %9u %9ld\n", nWin, (next - start) / 1e6, visits,
+                 visits * 1000.0 / sh->fSt.window, histPercentile (&win, 50.0) / 1e3, histPercentile (&win, 99.0) / 1e3,
+                 win.max / 1e3, inUse, rss);
+        fflush (fic);
+        if ((sh->fSt.duration > 0) && (next >= end)) {
+            break;
+        }
+    }
+
+    /* no group starts a new visit from now on; the agent that finds the arrival queue empty passes this up on */
+    lock (sh, semgid);
+    sh->fSt.closing = true;
+    unlock (sh, semgid);
+    if (semUp (semgid, sh->groupArrival) == -1) {
+        perror ("error on the up operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+
+    fprintf (fic, "\nContinuous service (%d windows of %d ms, %s)\n", nWin, sh->fSt.window,
+             stopRequested ? "ended by a signal" : "ended by the duration");
+    fprintf (fic, "  visits             : %d ended, %.1f per second (window min %d, max %d)\n", prevLeft,
+             (nWin > 0) ? prevLeft * 1000.0 / ((double) nWin * sh->fSt.window) : 0.0, minVisits, maxVisits);
+    fprintf (fic, "  served after       : mean %.3f ms, p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms "
+             "(arrival -> food served)\n", (total.n > 0) ? total.sum / total.n / 1e3 : 0.0,
+             histPercentile (&total, 50.0) / 1e3, histPercentile (&total, 90.0) / 1e3,
+             histPercentile (&total, 99.0) / 1e3, total.max / 1e3);
+    fprintf (fic, "  order payloads     : peak %u in use at the end of a window\n", inUsePeak);
+    fprintf (fic, "  resident memory    : %ld KB in the first window, %ld KB in the last "
+             "(staff, kitchen workers and launcher)\n", rssFirst, rssLast);
+    fflush (fic);
+}
+
+/**
+ *  \brief Ending the service, once all groups are gone.
+ *
+ *  The waiter and the receptionist get an end of service request and the workers of every station of the
+ *  kitchen are woken, so that all of them see that there is no more work and terminate.
+ *
+ *  \param sh pointer to the shared region
+ *  \param semgid semaphore set access identifier
+ */
+void soakClose (SHARED_DATA *sh, int semgid)
+{
+    int s;
+
+    closeRequest (sh, semgid, &sh->fSt.waiterRequest, sh->waiterRequestPossible, sh->waiterRequest);
+    closeRequest (sh, semgid, &sh->fSt.receptionistRequest, sh->receptionistRequestPossible, sh->receptionistReq);
+    for (s = 0; s < NSTATIONS; s++) {
+        if (semUp (semgid, sh->stationOrder[s]) == -1) {
+            perror ("error on the up operation for semaphore access");
+            exit (EXIT_FAILURE);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+/**
+ *  \file soak.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Continuous service mode of the launcher.
+ *
+ *  Defined operations:
+ *     \li serving continuously, with one line of measurements per window
+ *     \li ending the service, once all groups are gone.
+ *
+ *  In the continuous mode the groups come back to the restaurant after leaving and the staff keep working until
+ *  the launcher ends the service, after the configured duration or on SIGINT or SIGTERM. The groups then finish
+ *  their visits and terminate; when all of them are gone the kitchen and the tables are empty, and the launcher
+ *  tells the staff to terminate. Every window reports the visits ended, the time from arrival to the food being
+ *  served, the order payloads in use and the resident memory of the staff (with the kitchen workers, whose process
+ *  identifiers the chef stores in the shared region) and of the launcher, so that the steady state and the
+ *  memory stability of long runs can be followed.
+ */
+
+#ifndef SOAK_H_
+#define SOAK_H_
+
+#include <stdio.h>
+#include <sys/types.h>
+
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Serving continuously, with one line of measurements per window.
+ *
+ *  Returns when the duration of the service has elapsed or SIGINT or SIGTERM was received, after closing the
+ *  restaurant to new visits and printing a summary of all windows. Must be called after the start of operations.
+ *
+ *  \param fic stream where the measurements are printed
+ *  \param sh pointer to the shared region
+ *  \param semgid semaphore set access identifier
+ *  \param staff process identifiers of the staff (chef, waiter and receptionist)
+ */
+extern void soakRun (FILE *fic, SHARED_DATA *sh, int semgid, pid_t staff[3]);
+
+/**
+ *  \brief Ending the service, once all groups are gone.
+ *
+ *  The waiter and the receptionist get an end of service request and the workers of every station of the
+ *  kitchen are woken, so that all of them see that there is no more work and terminate.
+ *
+ *  \param sh pointer to the shared region
+ *  \param semgid semaphore set access identifier
+ */
+extern void soakClose (SHARED_DATA *sh, int semgid);
+
+#endif /* SOAK_H_ */
@@ -0,0 +1,194 @@
+/**
+ *  \file stats.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Descriptive statistics of samples.
+ *
+ *  Defined operations:
+ *     \li mean of a sample
+ *     \li percentile of a sample
+ *     \li variance of a sample
+ *     \li distribution function and quantile of the Student t distribution.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+/** \brief largest number of terms of the continued fraction of the incomplete beta function */
+#define  MAXTERMS           300
+
+/** \brief relative precision of the incomplete beta function */
+#define  EPS                1e-12
+
+/* internal functions */
+
+static int cmpDouble (const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+
+    return (x > y) - (x < y);
+}
+
+/** \brief continued fraction of the regularized incomplete beta function (modified Lentz method) */
+static double betaFrac (double a, double b, double x)
+{
+    double c = 1.0, d, h, num, delta;
+    int m;
+
+    d = 1.0 - (a + b) * x / (a + 1.0);
+    d = (fabs (d) < 1e-300) ? 1e300 : 1.0 / d;
+    h = d;
+    for (m = 1; m <= MAXTERMS; m++) {
+        num = m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m));                                 /* even step */
+        d = 1.0 + num * d;
+        d = (fabs (d) < 1e-300) ? 1e300 : 1.0 / d;
+        c = 1.0 + num / c;
+        c = (fabs (c) < 1e-300) ? 1e-300 : c;
+        h *= d * c;
+        num = -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));                       /* odd step */
+        d = 1.0 + num * d;
+        d = (fabs (d) < 1e-300) ? 1e300 : 1.0 / d;
+        c = 1.0 + num / c;
+        c = (fabs (c) < 1e-300) ? 1e-300 : c;
+        delta = d * c;
+        h *= delta;
+        if (fabs (delta - 1.0) < EPS) {
+            break;
+        }
+    }
+    return h;
+}
+
+/** \brief regularized incomplete beta function I_x(a, b) */
+static double betaInc (double a, double b, double x)
+{
+    double front;
+
+    if (x <= 0.0) {
+        return 0.0;
+    }
+    if (x >= 1.0) {
+        return 1.0;
+    }
+    front = exp (lgamma (a + b) - lgamma (a) - lgamma (b) + a * log (x) + b * log (1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0)) {
+        return front * betaFrac (a, b, x) / a;
+    }
+    return 1.0 - front * betaFrac (b, a, 1.0 - x) / b;
+}
+
+/* external functions */
+
+/**
+ *  \brief Mean of a sample.
+ *
+ *  \param v sample values
+ *  \param n number of values
+ *
+ *  \return mean value (0 for an empty sample)
+ */
+double statMean (double v[], int n)
+{
+    double sum = 0.0;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        sum += v[i];
+    }
+    return (n > 0) ? sum / n : 0.0;
+}
+
+/**
+ *  \brief Percentile of a sample.
+ *
+ *  The values are sorted in place; linear interpolation between closest ranks is used.
+ *
+ *  \param v sample values
+ *  \param n number of values
+ *  \param p percentile (0 .. 100)
+ *
+ *  \return value of the percentile (0 for an empty sample)
+ */
+double statPercentile (double v[], int n, double p)
+{
+    double rank;
+    int i;
+
+    if (n == 0) {
+        return 0.0;
+    }
+    qsort (v, n, sizeof (double), cmpDouble);
+    rank = p / 100.0 * (n - 1);
+    i = (int) rank;
+    if (i >= n - 1) {
+        return v[n-1];
+    }
+    return v[i] + (rank - i) * (v[i+1] - v[i]);
+}
+
+/**
+ *  \brief Variance of a sample.
+ *
+ *  \param v sample values
+ *  \param n number of values
+ *
+ *  \return unbiased sample variance (0 for samples with less than two values)
+ */
+double statVariance (double v[], int n)
+{
+    double mean = statMean (v, n), sum = 0.0;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        sum += (v[i] - mean) * (v[i] - mean);
+    }
+    return (n > 1) ? sum / (n - 1) : 0.0;
+}
+
+/**
+ *  \brief Distribution function of the Student t distribution.
+ *
+ *  \param t value
+ *  \param df degrees of freedom (> 0, not necessarily integer)
+ *
+ *  \return probability of a value not larger than t
+ */
+double statStudentCdf (double t, double df)
+{
+    double tail = 0.5 * betaInc (df / 2.0, 0.5, df / (df + t * t));
+
+    return (t > 0.0) ? 1.0 - tail : tail;
+}
+
+/**
+ *  \brief Quantile of the Student t distribution.
+ *
+ *  Computed by bisection of the distribution function.
+ *
+ *  \param p probability (0 .. 1, exclusive)
+ *  \param df degrees of freedom (> 0, not necessarily integer)
+ *
+ *  \return value t such that the probability of a value not larger than t is p
+ */
+double statStudentQuantile (double p, double df)
+{
+    double lo = -1.0, hi = 1.0, mid;
+    int i;
+
+    while (statStudentCdf (lo, df) > p) {
+        lo *= 2.0;
+    }
+    while (statStudentCdf (hi, df) < p) {
+        hi *= 2.0;
+    }
+    for (i = 0; i < 100; i++) {
+        mid = (lo + hi) / 2.0;
+        if (statStudentCdf (mid, df) < p) {
+            lo = mid;
+        }
+        else hi = mid;
+    }
+    return (lo + hi) / 2.0;
+}
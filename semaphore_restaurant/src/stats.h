@@ -0,0 +1,73 @@
+/**
+ *  \file stats.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Descriptive statistics of samples.
+ *
+ *  Defined operations:
+ *     \li mean of a sample
+ *     \li percentile of a sample
+ *     \li variance of a sample
+ *     \li distribution function and quantile of the Student t distribution.
+ */
+
+#ifndef STATS_H_
+#define STATS_H_
+
+/**
+ *  \brief Mean of a sample.
+ *
+ *  \param v sample values
+ *  \param n number of values
+ *
+ *  \return mean value (0 for an empty sample)
+ */
+extern double statMean (double v[], int n);
+
+/**
+ *  \brief Percentile of a sample.
+ *
+ *  The values are sorted in place; linear interpolation between closest ranks is used.
+ *
+ *  \param v sample values
+ *  \param n number of values
+ *  \param p percentile (0 .. 100)
+ *
+ *  \return value of the percentile (0 for an empty sample)
+ */
+extern double statPercentile (double v[], int n, double p);
+
+/**
+ *  \brief Variance of a sample.
+ *
+ *  \param v sample values
+ *  \param n number of values
+ *
+ *  \return unbiased sample variance (0 for samples with less than two values)
+ */
+extern double statVariance (double v[], int n);
+
+/**
+ *  \brief Distribution function of the Student t distribution.
+ *
+ *  \param t value
+ *  \param df degrees of freedom (> 0, not necessarily integer)
+ *
+ *  \return probability of a value not larger than t
+ */
+extern double statStudentCdf (double t, double df);
+
+/**
+ *  \brief Quantile of the Student t distribution.
+ *
+ *  Computed by bisection of the distribution function.
+ *
+ *  \param p probability (0 .. 1, exclusive)
+ *  \param df degrees of freedom (> 0, not necessarily integer)
+ *
+ *  \return value t such that the probability of a value not larger than t is p
+ */
+extern double statStudentQuantile (double p, double df);
+
+#endif /* STATS_H_ */
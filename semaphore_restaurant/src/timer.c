@@ -0,0 +1,249 @@
+/**
+ *  \file timer.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Timer wheel that wakes the group agents.
+ *
+ *  Defined operations:
+ *     \li sleeping of a group agent until a time stamp
+ *     \li start of the timer thread
+ *     \li end of the timer thread.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "probConst.h"
+#include "probDataStruct.h"
+#include "sharedDataSync.h"
+#include "semaphore.h"
+#include "timing.h"
+#include "timer.h"
+
+/* state of the timer thread (launcher only) */
+
+/** \brief pointer to the shared region */
+static SHARED_DATA *sh;
+
+/** \brief semaphore set access identifier */
+static int semgid;
+
+/** \brief timer thread */
+static pthread_t thread;
+
+/** \brief flag of end of the timer thread */
+static bool stopping = false;
+
+/** \brief first timer of each slot of the wheel (agent id, -1 if none) */
+static int slotHead[MAXWHEEL];
+
+/** \brief next timer in the slot of the timer of each agent (-1 if none) */
+static int nextTimer[MAXGROUPS];
+
+/** \brief turns of the wheel still to go before the timer of each agent fires */
+static long long turns[MAXGROUPS];
+
+/** \brief number of timers in the wheel */
+static int nPending = 0;
+
+/** \brief tick of the wheel processed last (ticks since the start of operations) */
+static long long cur;
+
+/** \brief number of timers taken from the ring (the next one is at entry head % MAXGROUPS) */
+static unsigned long long head = 0;
+
+/* internal functions */
+
+/** \brief tick a time stamp falls in (ticks since the start of operations) */
+static long long tickOf (long long t)
+{
+    return (t - sh->fSt.runStart) / sh->fSt.timerTick;
+}
+
+/** \brief firing of the timer of an agent */
+static void fire (int agent)
+{
+    sh->fSt.timerFired++;
+    if (semUp (semgid, sh->timerExpired[agent]) == -1) {
+        perror ("error on the up operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+}
+
+/** \brief taking the next timer posted from the ring and putting it in the wheel */
+static void take (void)
+{
+    int *entry = &sh->fSt.timerRing[head % MAXGROUPS];
+    int v, agent;
+    long long t, slot;
+
+    while ((v = __atomic_load_n (entry, __ATOMIC_ACQUIRE)) == 0) {     /* the agent is between claim and store */
+        sched_yield ();
+    }
+    __atomic_store_n (entry, 0, __ATOMIC_RELAXED);
+    head++;
+
+    agent = v - 1;
+    t = tickOf (sh->fSt.timerDue[agent] + sh->fSt.timerTick - 1);                  /* first tick not before it */
+    if (t <= cur) {
+        fire (agent);                                                                  /* expired already */
+        return;
+    }
+    slot = t % sh->fSt.timerSlots;
+    turns[agent] = (t - cur - 1) / sh->fSt.timerSlots;
+    nextTimer[agent] = slotHead[slot];
+    slotHead[slot] = agent;
+    nPending++;
+}
+
+/** \brief processing of the next tick: the timers of its slot fire or have one turn less to go */
+static void advance (void)
+{
+    int *link, agent;
+
+    cur++;
+    sh->fSt.timerTicks++;
+    for (link = &slotHead[cur % sh->fSt.timerSlots]; (agent = *link) != -1; ) {
+        sh->fSt.timerVisits++;
+        if (turns[agent] == 0) {
+            *link = nextTimer[agent];
+            nPending--;
+            fire (agent);
+        }
+        else {
+            turns[agent]--;
+            link = &nextTimer[agent];
+        }
+    }
+}
+
+/** \brief life cycle of the timer thread */
+static void *timerRun (void *arg)
+{
+    sigset_t set;
+    long long wait;
+    int ret;
+
+    /* the end of service signals of the continuous mode are left to the main thread */
+    sigemptyset (&set);
+    sigaddset (&set, SIGINT);
+    sigaddset (&set, SIGTERM);
+    pthread_sigmask (SIG_BLOCK, &set, NULL);
+
+    cur = tickOf (timeNow ());
+    while (true) {
+        if (nPending == 0) {                             /* nothing to fire: sleeping until a timer is posted */
+            ret = semDown (semgid, sh->timerReq);
+            cur = tickOf (timeNow ());
+        }
+        else if ((wait = sh->fSt.runStart + (cur + 1) * sh->fSt.timerTick - timeNow ()) > 0) {
+            ret = semTimedDown (semgid, sh->timerReq, (long) wait);
+        }
+        else {
+            advance ();
+            continue;
+        }
+        if (ret == 0) {
+            if (__atomic_load_n (&stopping, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            take ();
+        }
+        else if ((errno != EAGAIN) && (errno != EINTR)) {
+            perror ("error on the down operation for semaphore access");
+            exit (EXIT_FAILURE);
+        }
+    }
+    return NULL;
+}
+
+/* external functions */
+
+/**
+ *  \brief Sleeping of a group agent until a time stamp.
+ *
+ *  With the timer wheel (timerTick > 0) the agent posts a timer and waits for it to fire; otherwise it sleeps by
+ *  itself. Returns at once if the time stamp has passed.
+ *
+ *  \param sh pointer to the shared region
+ *  \param semgid semaphore set access identifier
+ *  \param agent agent id
+ *  \param due time stamp (us) until which the agent sleeps
+ *
+ *  \return \c true if the agent slept, \c false if the time stamp had passed
+ */
+bool timerSleep (SHARED_DATA *sh, int semgid, int agent, long long due)
+{
+    long long now = timeNow ();
+    unsigned long long pos;
+
+    if (due <= now) {
+        return false;
+    }
+    if (sh->fSt.timerTick == 0) {
+        usleep ((unsigned int) (due - now));
+        return true;
+    }
+
+    /* the entry is claimed first and filled last, so the timer thread never takes a half-written timer */
+    pos = __atomic_fetch_add (&sh->fSt.timerTail, 1, __ATOMIC_RELAXED);
+    sh->fSt.timerDue[agent] = due;
+    __atomic_store_n (&sh->fSt.timerRing[pos % MAXGROUPS], agent + 1, __ATOMIC_RELEASE);
+    if (semUp (semgid, sh->timerReq) == -1) {
+        perror ("error on the up operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+    if (semDown (semgid, sh->timerExpired[agent]) == -1) {
+        perror ("error on the down operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+    return true;
+}
+
+/**
+ *  \brief Start of the timer thread.
+ *
+ *  Must be called by the launcher, after the start of operations.
+ *
+ *  \param shared pointer to the shared region
+ *  \param sgid semaphore set access identifier
+ */
+void timerStart (SHARED_DATA *shared, int sgid)
+{
+    int s;
+
+    sh = shared;
+    semgid = sgid;
+    for (s = 0; s < MAXWHEEL; s++) {
+        slotHead[s] = -1;
+    }
+    if ((errno = pthread_create (&thread, NULL, timerRun, NULL)) != 0) {
+        perror ("error on creating the timer thread");
+        exit (EXIT_FAILURE);
+    }
+}
+
+/**
+ *  \brief End of the timer thread.
+ *
+ *  Must be called by the launcher, once all group agents are gone.
+ */
+void timerStop (void)
+{
+    __atomic_store_n (&stopping, true, __ATOMIC_RELEASE);
+    if (semUp (semgid, sh->timerReq) == -1) {
+        perror ("error on the up operation for semaphore access");
+        exit (EXIT_FAILURE);
+    }
+    if ((errno = pthread_join (thread, NULL)) != 0) {
+        perror ("error on waiting for the timer thread");
+        exit (EXIT_FAILURE);
+    }
+}
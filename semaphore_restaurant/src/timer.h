@@ -0,0 +1,61 @@
+/**
+ *  \file timer.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Timer wheel that wakes the group agents.
+ *
+ *  Defined operations:
+ *     \li sleeping of a group agent until a time stamp
+ *     \li start of the timer thread
+ *     \li end of the timer thread.
+ *
+ *  Instead of sleeping by itself (usleep) on the way to the restaurant and while eating, a group agent posts a timer
+ *  and waits on its own semaphore. The timer thread of the launcher keeps the timers in a hashed timing wheel of
+ *  timerSlots slots of timerTick us: a timer goes to the slot of the tick it expires on, with the number of turns
+ *  of the wheel still to go, and every tick looks only at the timers of its slot, so that inserting and firing a
+ *  timer are constant time. While there are no timers the thread sleeps until one is posted. Timers are posted
+ *  through a ring in the shared region without the mutex: each agent has at most one timer, so the ring never holds
+ *  more than MAXGROUPS of them.
+ */
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <stdbool.h>
+
+#include "sharedDataSync.h"
+
+/**
+ *  \brief Sleeping of a group agent until a time stamp.
+ *
+ *  With the timer wheel (timerTick > 0) the agent posts a timer and waits for it to fire; otherwise it sleeps by
+ *  itself. Returns at once if the time stamp has passed.
+ *
+ *  \param sh pointer to the shared region
+ *  \param semgid semaphore set access identifier
+ *  \param agent agent id
+ *  \param due time stamp (us) until which the agent sleeps
+ *
+ *  \return \c true if the agent slept, \c false if the time stamp had passed
+ */
+extern bool timerSleep (SHARED_DATA *sh, int semgid, int agent, long long due);
+
+/**
+ *  \brief Start of the timer thread.
+ *
+ *  Must be called by the launcher, after the start of operations.
+ *
+ *  \param shared pointer to the shared region
+ *  \param sgid semaphore set access identifier
+ */
+extern void timerStart (SHARED_DATA *shared, int sgid);
+
+/**
+ *  \brief End of the timer thread.
+ *
+ *  Must be called by the launcher, once all group agents are gone.
+ */
+extern void timerStop (void);
+
+#endif /* TIMER_H_ */
@@ -0,0 +1,49 @@
+/**
+ *  \file timing.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Time stamps shared by all the intervening entities.
+ *
+ *  Defined operations:
+ *     \li reading the present time in microseconds
+ *     \li reading the present time in nanoseconds.
+ *
+ *  The clock is monotonic and system wide, so time stamps taken by different processes can be compared.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ *  \brief Reading the present time.
+ *
+ *  \return present value of the monotonic clock, in microseconds
+ */
+long long timeNow (void)
+{
+    struct timespec ts;
+
+    if (clock_gettime (CLOCK_MONOTONIC, &ts) == -1) {
+        perror ("error on reading the monotonic clock");
+        exit (EXIT_FAILURE);
+    }
+    return (long long) ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+/**
+ *  \brief Reading the present time with full resolution (for micro-benchmarks).
+ *
+ *  \return present value of the monotonic clock, in nanoseconds
+ */
+long long timeNowNs (void)
+{
+    struct timespec ts;
+
+    if (clock_gettime (CLOCK_MONOTONIC, &ts) == -1) {
+        perror ("error on reading the monotonic clock");
+        exit (EXIT_FAILURE);
+    }
+    return (long long) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
@@ -0,0 +1,32 @@
+/**
+ *  \file timing.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Time stamps shared by all the intervening entities.
+ *
+ *  Defined operations:
+ *     \li reading the present time in microseconds
+ *     \li reading the present time in nanoseconds.
+ *
+ *  The clock is monotonic and system wide, so time stamps taken by different processes can be compared.
+ */
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+/**
+ *  \brief Reading the present time.
+ *
+ *  \return present value of the monotonic clock, in microseconds
+ */
+extern long long timeNow (void);
+
+/**
+ *  \brief Reading the present time with full resolution (for micro-benchmarks).
+ *
+ *  \return present value of the monotonic clock, in nanoseconds
+ */
+extern long long timeNowNs (void);
+
+#endif /* TIMING_H_ */
@@ -0,0 +1,284 @@
+/**
+ *  \file trace.c (implementation file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Execution trace in Trace Event Format (Chrome tracing / Perfetto).
+ *
+ *  Defined operations:
+ *     \li creation and termination of the trace file (launcher)
+ *     \li opening the track of an intervening entity
+ *     \li change of state of an entity
+ *     \li hand-off of a request between entities
+ *     \li wait on a semaphore
+ *     \li closing the track of an intervening entity.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "probConst.h"
+#include "timing.h"
+#include "trace.h"
+
+/** \brief maximum length of an event */
+#define  EVENTLEN           512
+
+/** \brief track id of the first group (the chef, waiter and receptionist use 1, 2 and 3) */
+#define  GROUPTID           10
+
+/** \brief names of the kinds of entities */
+static const char *kindNames[] = { "chef", "waiter", "receptionist", "group" };
+
+/** \brief names of the chef states */
+static const char *chefStates[] = { "WAIT_FOR_ORDER", "COOK", "REST" };
+
+/** \brief names of the waiter states */
+static const char *waiterStates[] = { "WAIT_FOR_REQUEST", "INFORM_CHEF", "TAKE_TO_TABLE" };
+
+/** \brief names of the receptionist states */
+static const char *receptionistStates[] = { "WAIT_FOR_REQUEST", "ASSIGNTABLE", "RECVPAY" };
+
+/** \brief names of the group states */
+static const char *groupStates[] = { "", "GOTOREST", "ATRECEPTION", "FOOD_REQUEST", "WAIT_FOR_FOOD", "EAT",
+                                     "CHECKOUT", "LEAVING" };
+
+/** \brief names of the requests */
+static const char *reqNames[] = { "", "TABLEREQ", "BILLREQ", "FOODREQ", "FOODREADY" };
+
+/** \brief trace file descriptor (-1 if tracing is disabled) */
+static int fd = -1;
+
+/** \brief name of the trace file (launcher) */
+static char *traceName = NULL;
+
+/** \brief track id of the entity */
+static int tid;
+
+/** \brief names of the states of the entity */
+static const char **stateNames;
+
+/** \brief number of states of the entity */
+static unsigned int nStates;
+
+/** \brief present state of the entity */
+static unsigned int curState;
+
+/** \brief time stamp (ns) of entering the present state */
+static long long curStart;
+
+/* internal functions */
+
+/** \brief appending an event to the trace file, with a single write */
+static void emit (const char *fmt, ...)
+{
+    char ev[EVENTLEN];
+    va_list ap;
+    int n;
+
+    va_start (ap, fmt);
+    n = vsnprintf (ev, EVENTLEN - 2, fmt, ap);
+    va_end (ap);
+    if (n > EVENTLEN - 3) {
+        n = EVENTLEN - 3;
+    }
+    ev[n++] = ',';
+    ev[n++] = '\n';
+    if (write (fd, ev, n) != n) {
+        perror ("error on writing the trace file");
+    }
+}
+
+/** \brief name of a state of the entity */
+static const char *stateName (unsigned int state)
+{
+    return (state < nStates) ? stateNames[state] : "UNKNOWN";
+}
+
+/** \brief span of the present state, up to t (ns) */
+static void closeSpan (long long t)
+{
+    emit ("{\"name\":\"%s\",\"cat\":\"state\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+          stateName (curState), tid, curStart / 1e3, (t - curStart) / 1e3);
+}
+
+/* external functions */
+
+/**
+ *  \brief Creation of the trace file (launcher).
+ *
+ *  The file is truncated and its name exported in TRACEENV, so that the entities generated afterwards trace.
+ *
+ *  \param nTrace name of the trace file
+ */
+void traceCreate (char *nTrace)
+{
+    if ((fd = open (nTrace, O_WRONLY | O_CREAT | O_TRUNC, 0600)) == -1) {
+        perror ("error on creating the trace file");
+        exit (EXIT_FAILURE);
+    }
+    if (write (fd, "[\n", 2) != 2) {
+        perror ("error on writing the trace file");
+        exit (EXIT_FAILURE);
+    }
+    emit ("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"restaurant\"}}");
+    close (fd);
+    fd = -1;
+    traceName = nTrace;
+    if (setenv (TRACEENV, nTrace, 1) == -1) {
+        perror ("error on exporting the name of the trace file");
+        exit (EXIT_FAILURE);
+    }
+}
+
+/**
+ *  \brief Termination of the trace file (launcher).
+ *
+ *  Must be called after all intervening entities have terminated.
+ */
+void traceFinish (void)
+{
+    char end[] = "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":1,\"args\":{\"sort_index\":0}}\n]\n";
+
+    if (traceName == NULL) {
+        return;
+    }
+    if (((fd = open (traceName, O_WRONLY | O_APPEND)) == -1) || (write (fd, end, strlen (end)) != strlen (end))) {
+        perror ("error on terminating the trace file");
+        exit (EXIT_FAILURE);
+    }
+    close (fd);
+    fd = -1;
+}
+
+/**
+ *  \brief Opening the track of an intervening entity.
+ *
+ *  Does nothing if TRACEENV is not set.
+ *
+ *  \param kind kind of entity (TR_CHEF, TR_WAITER, TR_RECEPTIONIST or TR_GROUP)
+ *  \param id entity id (group agent id, kitchen worker id for the chef; 0 for the others)
+ *  \param state initial state
+ */
+void traceOpen (int kind, int id, unsigned int state)
+{
+    char *nTrace = getenv (TRACEENV);
+
+    if ((nTrace == NULL) || ((fd = open (nTrace, O_WRONLY | O_APPEND)) == -1)) {
+        fd = -1;
+        return;
+    }
+    switch (kind) {
+        case TR_CHEF:         stateNames = chefStates;
+                              nStates = sizeof (chefStates) / sizeof (chefStates[0]);
+                              tid = (id == 0) ? 1 : GROUPTID + MAXGROUPS + id;
+                              break;
+        case TR_WAITER:       stateNames = waiterStates;
+                              nStates = sizeof (waiterStates) / sizeof (waiterStates[0]);
+                              tid = 2;
+                              break;
+        case TR_RECEPTIONIST: stateNames = receptionistStates;
+                              nStates = sizeof (receptionistStates) / sizeof (receptionistStates[0]);
+                              tid = 3;
+                              break;
+        default:              stateNames = groupStates;
+                              nStates = sizeof (groupStates) / sizeof (groupStates[0]);
+                              tid = GROUPTID + id;
+                              kind = TR_GROUP;
+    }
+    if (kind == TR_GROUP) {
+        emit ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"group agent %d\"}}", tid, id);
+    }
+    else if ((kind == TR_CHEF) && (id > 0)) {
+        emit ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"kitchen worker %d\"}}", tid, id);
+    }
+    else emit ("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}", tid, kindNames[kind]);
+    emit ("{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"sort_index\":%d}}", tid, tid);
+    curState = state;
+    curStart = timeNowNs ();
+}
+
+/**
+ *  \brief Change of state of the entity.
+ *
+ *  The span of the previous state ends and the span of the new one starts.
+ *
+ *  \param state new state
+ */
+void traceState (unsigned int state)
+{
+    long long now;
+
+    if (fd == -1) {
+        return;
+    }
+    now = timeNowNs ();
+    closeSpan (now);
+    curState = state;
+    curStart = now;
+}
+
+/**
+ *  \brief Hand-off of a request.
+ *
+ *  \param reqType request id
+ *  \param key request key (the group, for requests issued by groups; a sequence number for FOODREADY)
+ *  \param issue true at the entity issuing the request, false at the one serving it
+ */
+void traceFlow (int reqType, int key, bool issue)
+{
+    if (fd == -1) {
+        return;
+    }
+    emit ("{\"name\":\"%s\",\"cat\":\"request\",\"ph\":\"%s\",\"id\":%d,\"pid\":1,\"tid\":%d,\"ts\":%.3f%s}",
+          ((reqType > 0) && (reqType <= FOODREADY)) ? reqNames[reqType] : "REQUEST", issue ? "s" : "f",
+          (reqType << 16) | key, tid, timeNowNs () / 1e3, issue ? "" : ",\"bp\":\"e\"");
+}
+
+/**
+ *  \brief Checking if tracing is enabled in this process.
+ *
+ *  \return true if the track of the entity is open
+ */
+bool traceOn (void)
+{
+    return fd != -1;
+}
+
+/**
+ *  \brief Wait on a semaphore.
+ *
+ *  Waits shorter than TRACEMINWAIT are not traced.
+ *
+ *  \param sindex semaphore location in the set
+ *  \param t0 time stamp (ns) of the start of the <em>down</em>
+ *  \param t1 time stamp (ns) of the end of the <em>down</em>
+ */
+void traceSemWait (unsigned int sindex, long long t0, long long t1)
+{
+    if ((fd == -1) || (t1 - t0 < TRACEMINWAIT)) {
+        return;
+    }
+    emit ("{\"name\":\"down sem %u\",\"cat\":\"semaphore\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+          "\"args\":{\"sem\":%u}}", sindex, tid, t0 / 1e3, (t1 - t0) / 1e3, sindex);
+}
+
+/**
+ *  \brief Closing the track of the entity.
+ *
+ *  The span of the last state ends.
+ */
+void traceClose (void)
+{
+    if (fd == -1) {
+        return;
+    }
+    closeSpan (timeNowNs ());
+    close (fd);
+    fd = -1;
+}
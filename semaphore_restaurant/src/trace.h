@@ -0,0 +1,115 @@
+/**
+ *  \file trace.h (interface file)
+ *
+ *  \brief Problem name: Restaurant
+ *
+ *  \brief Execution trace in Trace Event Format (Chrome tracing / Perfetto).
+ *
+ *  Defined operations:
+ *     \li creation and termination of the trace file (launcher)
+ *     \li opening the track of an intervening entity
+ *     \li change of state of an entity
+ *     \li hand-off of a request between entities
+ *     \li wait on a semaphore
+ *     \li closing the track of an intervening entity.
+ *
+ *  Tracing is enabled when the launcher is run with <tt>-t file</tt>: the name of the file is passed on to the
+ *  entities in the environment variable TRACEENV. Each entity has its own track, with one span per state, a
+ *  span per blocking <em>down</em> longer than TRACEMINWAIT and flow arrows from the issue of every request
+ *  (TABLEREQ, FOODREQ, FOODREADY, BILLREQ) to the entity that serves it. Each event is appended to the file
+ *  with a single write, so the processes never need to synchronize. When tracing is disabled every operation
+ *  returns immediately.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdbool.h>
+
+/** \brief environment variable with the name of the trace file */
+#define  TRACEENV           "RESTAURANT_TRACE"
+
+/** \brief shortest wait on a semaphore that is traced (ns) */
+#define  TRACEMINWAIT       2000
+
+/* kinds of intervening entities */
+/** \brief chef */
+#define  TR_CHEF            0
+/** \brief waiter */
+#define  TR_WAITER          1
+/** \brief receptionist */
+#define  TR_RECEPTIONIST    2
+/** \brief group */
+#define  TR_GROUP           3
+
+/**
+ *  \brief Creation of the trace file (launcher).
+ *
+ *  The file is truncated and its name exported in TRACEENV, so that the entities generated afterwards trace.
+ *
+ *  \param nTrace name of the trace file
+ */
+extern void traceCreate (char *nTrace);
+
+/**
+ *  \brief Termination of the trace file (launcher).
+ *
+ *  Must be called after all intervening entities have terminated.
+ */
+extern void traceFinish (void);
+
+/**
+ *  \brief Opening the track of an intervening entity.
+ *
+ *  Does nothing if TRACEENV is not set.
+ *
+ *  \param kind kind of entity (TR_CHEF, TR_WAITER, TR_RECEPTIONIST or TR_GROUP)
+ *  \param id entity id (group agent id, kitchen worker id for the chef; 0 for the others)
+ *  \param state initial state
+ */
+extern void traceOpen (int kind, int id, unsigned int state);
+
+/**
+ *  \brief Change of state of the entity.
+ *
+ *  The span of the previous state ends and the span of the new one starts.
+ *
+ *  \param state new state
+ */
+extern void traceState (unsigned int state);
+
+/**
+ *  \brief Hand-off of a request.
+ *
+ *  \param reqType request id
+ *  \param key request key (the group, for requests issued by groups; a sequence number for FOODREADY)
+ *  \param issue true at the entity issuing the request, false at the one serving it
+ */
+extern void traceFlow (int reqType, int key, bool issue);
+
+/**
+ *  \brief Checking if tracing is enabled in this process.
+ *
+ *  \return true if the track of the entity is open
+ */
+extern bool traceOn (void);
+
+/**
+ *  \brief Wait on a semaphore.
+ *
+ *  Waits shorter than TRACEMINWAIT are not traced.
+ *
+ *  \param sindex semaphore location in the set
+ *  \param t0 time stamp (ns) of the start of the <em>down</em>
+ *  \param t1 time stamp (ns) of the end of the <em>down</em>
+ */
+extern void traceSemWait (unsigned int sindex, long long t0, long long t1);
+
+/**
+ *  \brief Closing the track of the entity.
+ *
+ *  The span of the last state ends.
+ */
+extern void traceClose (void);
+
+#endif /* TRACE_H_ */